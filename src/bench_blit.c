@@ -0,0 +1,98 @@
+// Sprite blitter benchmark
+//
+// Draws sprites of a few sizes into an off screen target with DrawSprite, and
+// again with the per-pixel loop DrawSprite used before the clipped blitter
+// (column major, olc_Sprite_GetPixel and Draw for every pixel), and reports
+// sprites per second for both. Build it like test.c, against engine.c and SDL2.
+#include "engine.h"
+
+#define nTargetWidth  640
+#define nTargetHeight 480
+#define nPixelBudget  (1 << 26)
+
+// The old path, kept here only to be measured against
+void OldDrawSprite(int32_t x, int32_t y, olc_Sprite* sprite, uint8_t flip)
+{
+    int32_t fxs = 0, fxm = 1, fx = 0;
+    int32_t fys = 0, fym = 1, fy = 0;
+
+    if(flip & olc_SPRITEFLIP_HORIZ) { fxs = sprite->width - 1; fxm = -1; }
+    if(flip & olc_SPRITEFLIP_VERT) { fys = sprite->height - 1; fym = -1; }
+
+    fx = fxs;
+    for(int32_t i = 0; i < sprite->width; i++, fx += fxm)
+    {
+        fy = fys;
+        for(int32_t j = 0; j < sprite->height; j++, fy += fym)
+            Draw(x + i, y + j, olc_Sprite_GetPixel(sprite, fx, fy));
+    }
+}
+
+// time nCount draws of sprite at pseudo random positions, a few of them
+// partly off the target, and return sprites per second
+double Measure(olc_Sprite* sprite, uint8_t flip, bool bOld, int32_t nCount)
+{
+    uint32_t seed = 777;
+    uint64_t t0 = SDL_GetPerformanceCounter();
+
+    for(int32_t i = 0; i < nCount; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        int32_t x = (int32_t)((seed >> 8) % (nTargetWidth + sprite->width)) - sprite->width / 2;
+        int32_t y = (int32_t)((seed >> 20) % (nTargetHeight + sprite->height)) - sprite->height / 2;
+
+        if(bOld) OldDrawSprite(x, y, sprite, flip);
+        else DrawSprite(x, y, sprite, 1, flip);
+    }
+
+    uint64_t t1 = SDL_GetPerformanceCounter();
+    return (double)nCount * (double)SDL_GetPerformanceFrequency() / (double)(t1 - t0);
+}
+
+int main(int argc, char* argv[])
+{
+    UNUSED(argc); UNUSED(argv);
+
+    if(Construct(nTargetWidth, nTargetHeight, 1, 1, false, false) != olc_RCODE_OK) return 1;
+
+    olc_Sprite* target = olc_Sprite_Create(nTargetWidth, nTargetHeight);
+    SetDrawTarget(target);
+    Clear(olc_DARK_BLUE);
+
+    struct { const char* sName; uint32_t nMode; uint8_t flip; } cases[] =
+    {
+        { "NORMAL",         olc_PIXELMODE_NORMAL, olc_SPRITEFLIP_NONE },
+        { "NORMAL flipped", olc_PIXELMODE_NORMAL, olc_SPRITEFLIP_HORIZ | olc_SPRITEFLIP_VERT },
+        { "MASK",           olc_PIXELMODE_MASK,   olc_SPRITEFLIP_NONE },
+        { "ALPHA",          olc_PIXELMODE_ALPHA,  olc_SPRITEFLIP_NONE },
+    };
+    int32_t sizes[] = { 8, 32, 128 };
+
+    printf("kernels: %s, target %dx%d\n", olc_Span.sName, nTargetWidth, nTargetHeight);
+    printf("%-16s %5s %14s %14s %8s\n", "mode", "size", "new sprites/s", "old sprites/s", "speedup");
+
+    for(size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            // a sprite with a mix of opaque, translucent and clear pixels
+            int32_t n = sizes[s];
+            olc_Sprite* sprite = olc_Sprite_Create(n, n);
+            for(int32_t y = 0; y < n; y++)
+                for(int32_t x = 0; x < n; x++)
+                    olc_Sprite_SetPixel(sprite, x, y, olc_PixelRGBA(x * 7, y * 5, x ^ y, ((x + y) % 4 == 0) ? 0 : ((x * y) % 3 == 0) ? 128 : 255));
+
+            SetPixelMode(cases[c].nMode);
+            int32_t nCount = nPixelBudget / (n * n);
+            double fNew = Measure(sprite, cases[c].flip, false, nCount);
+            double fOld = Measure(sprite, cases[c].flip, true, nCount / 8);
+            SetPixelMode(olc_PIXELMODE_NORMAL);
+
+            printf("%-16s %5d %14.0f %14.0f %7.1fx\n", cases[c].sName, n, fNew, fOld, fNew / fOld);
+            olc_Sprite_Destroy(sprite);
+        }
+    }
+
+    olc_Sprite_Destroy(target);
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Keycode translation microbenchmark
+//
+// Feeds a burst of key events through inputmap_get and olc_PGE_UpdateKeyState,
+// the work olc_Platform_HandleSystemEvent does per SDL key event, and compares
+// it with the linear scan over heap allocated nodes the engine used before.
+// Build it like test.c, against engine.c and SDL2.
+#include "engine.h"
+
+#define nEvents  (1 << 22)
+#define nRepeats 5
+
+// The old map, one malloc'd node per key, searched front to back
+typedef struct
+{
+    SDL_Keycode key;
+    uint8_t value;
+} OldKey;
+
+OldKey** pOldKeys;
+uint32_t nOldKeys;
+
+// the keys the old map was filled with, in the order it was filled
+static const OldKey vOldKeyList[] =
+{
+    { SDLK_UNKNOWN, olc_NONE },
+    { SDLK_a, olc_A }, { SDLK_b, olc_B }, { SDLK_c, olc_C }, { SDLK_d, olc_D },
+    { SDLK_e, olc_E }, { SDLK_f, olc_F }, { SDLK_g, olc_G }, { SDLK_h, olc_H },
+    { SDLK_i, olc_I }, { SDLK_j, olc_J }, { SDLK_k, olc_K }, { SDLK_l, olc_L },
+    { SDLK_m, olc_M }, { SDLK_n, olc_N }, { SDLK_o, olc_O }, { SDLK_p, olc_P },
+    { SDLK_q, olc_Q }, { SDLK_r, olc_R }, { SDLK_s, olc_S }, { SDLK_t, olc_T },
+    { SDLK_u, olc_U }, { SDLK_v, olc_V }, { SDLK_w, olc_W }, { SDLK_x, olc_X },
+    { SDLK_y, olc_Y }, { SDLK_z, olc_Z },
+
+    { SDLK_0, olc_K0 }, { SDLK_1, olc_K1 }, { SDLK_2, olc_K2 }, { SDLK_3, olc_K3 },
+    { SDLK_4, olc_K4 }, { SDLK_5, olc_K5 }, { SDLK_6, olc_K6 }, { SDLK_7, olc_K7 },
+    { SDLK_8, olc_K8 }, { SDLK_9, olc_K9 },
+
+    { SDLK_F1, olc_F1 }, { SDLK_F2, olc_F2 }, { SDLK_F3, olc_F3 }, { SDLK_F4, olc_F4 },
+    { SDLK_F5, olc_F5 }, { SDLK_F6, olc_F6 }, { SDLK_F7, olc_F7 }, { SDLK_F8, olc_F8 },
+    { SDLK_F9, olc_F9 }, { SDLK_F10, olc_F10 }, { SDLK_F11, olc_F11 }, { SDLK_F12, olc_F12 },
+
+    { SDLK_DOWN, olc_DOWN },         { SDLK_LEFT, olc_LEFT },
+    { SDLK_RIGHT, olc_RIGHT },       { SDLK_UP, olc_UP },
+    { SDLK_KP_ENTER, olc_ENTER },    { SDLK_RETURN, olc_ENTER },
+    { SDLK_BACKSPACE, olc_BACK },    { SDLK_ESCAPE, olc_ESCAPE },
+    { SDLK_RETURN, olc_ENTER },      { SDLK_PAUSE, olc_PAUSE },
+    { SDLK_SCROLLLOCK, olc_SCROLL }, { SDLK_TAB, olc_TAB },
+    { SDLK_DELETE, olc_DEL },        { SDLK_HOME, olc_HOME },
+    { SDLK_END, olc_END },           { SDLK_PAGEUP, olc_PGUP },
+    { SDLK_PAGEDOWN, olc_PGDN },     { SDLK_INSERT, olc_INS },
+    { SDLK_LSHIFT, olc_SHIFT },      { SDLK_RSHIFT, olc_SHIFT },
+    { SDLK_LCTRL, olc_CTRL },        { SDLK_RCTRL, olc_CTRL },
+    { SDLK_SPACE, olc_SPACE },
+
+    { SDLK_KP_0, olc_NP0 }, { SDLK_KP_1, olc_NP1 }, { SDLK_KP_2, olc_NP2 }, { SDLK_KP_3, olc_NP3 },
+    { SDLK_KP_4, olc_NP4 }, { SDLK_KP_5, olc_NP5 }, { SDLK_KP_6, olc_NP6 }, { SDLK_KP_7, olc_NP7 },
+    { SDLK_KP_8, olc_NP8 }, { SDLK_KP_9, olc_NP9 },
+
+    { SDLK_KP_MULTIPLY, olc_NP_MUL }, { SDLK_KP_DIVIDE, olc_NP_DIV },
+    { SDLK_KP_PLUS, olc_NP_ADD },     { SDLK_KP_MINUS, olc_NP_SUB },
+    { SDLK_KP_PERIOD, olc_NP_DECIMAL }, { SDLK_PERIOD, olc_PERIOD }
+};
+
+// as the old inputmap_set, a key already in the map has its value replaced
+void oldmap_set(SDL_Keycode key, uint8_t value)
+{
+    for(uint32_t i = 0; i < nOldKeys; i++)
+    {
+        if(pOldKeys[i]->key == key)
+        {
+            pOldKeys[i]->value = value;
+            return;
+        }
+    }
+
+    pOldKeys[nOldKeys] = (OldKey*)malloc(sizeof(OldKey));
+    pOldKeys[nOldKeys]->key = key;
+    pOldKeys[nOldKeys]->value = value;
+    nOldKeys++;
+}
+
+uint8_t oldmap_get(SDL_Keycode key)
+{
+    for(uint32_t i = 0; i < nOldKeys; i++)
+        if(pOldKeys[i]->key == key) return pOldKeys[i]->value;
+
+    return olc_NONE;
+}
+
+double seconds(uint64_t t0, uint64_t t1)
+{ return (double)(t1 - t0) / (double)SDL_GetPerformanceFrequency(); }
+
+int main(int argc, char* argv[])
+{
+    UNUSED(argc); UNUSED(argv);
+
+    uint32_t nList = sizeof(vOldKeyList) / sizeof(vOldKeyList[0]);
+    pOldKeys = (OldKey**)malloc(sizeof(OldKey*) * nList);
+    nOldKeys = 0;
+    for(uint32_t i = 0; i < nList; i++)
+        oldmap_set(vOldKeyList[i].key, vOldKeyList[i].value);
+
+    // a burst of presses and releases, one in eight of them for unmapped keys
+    SDL_Keycode* pEvents = (SDL_Keycode*)malloc(sizeof(SDL_Keycode) * nEvents);
+    uint32_t seed = 12345;
+    for(uint32_t i = 0; i < nEvents; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        pEvents[i] = ((seed >> 8) & 7) ? pOldKeys[(seed >> 12) % nOldKeys]->key : SDL_SCANCODE_TO_KEYCODE(300 + (seed >> 12) % 100);
+    }
+
+    double fTable = 1e9, fList = 1e9;
+    uint32_t nCheck = 0;
+    for(int32_t r = 0; r < nRepeats; r++)
+    {
+        uint64_t t0 = SDL_GetPerformanceCounter();
+        for(uint32_t i = 0; i < nEvents; i++)
+            olc_PGE_UpdateKeyState(inputmap_get(pEvents[i]), i & 1);
+        uint64_t t1 = SDL_GetPerformanceCounter();
+        for(uint32_t i = 0; i < nEvents; i++)
+            olc_PGE_UpdateKeyState(oldmap_get(pEvents[i]), i & 1);
+        uint64_t t2 = SDL_GetPerformanceCounter();
+
+        if(seconds(t0, t1) < fTable) fTable = seconds(t0, t1);
+        if(seconds(t1, t2) < fList)  fList  = seconds(t1, t2);
+    }
+
+    for(uint32_t i = 0; i < nEvents; i++)
+        nCheck += inputmap_get(pEvents[i]) != oldmap_get(pEvents[i]);
+
+    printf("%u mapped keys, %d key events, best of %d\n", nOldKeys, nEvents, nRepeats);
+    printf("  table       %8.2f M events/s\n", nEvents / fTable * 1e-6);
+    printf("  linear scan %8.2f M events/s\n", nEvents / fList * 1e-6);
+    printf("  mismatches  %u\n", nCheck);
+
+    for(uint32_t i = 0; i < nOldKeys; i++) free(pOldKeys[i]);
+    free(pOldKeys);
+    free(pEvents);
+
+    return (nCheck == 0) ? 0 : 1;
+}
@@ -12,9 +12,418 @@ olc_Pixel olc_GREY, olc_DARK_GREY, olc_VERY_DARK_GREY,
 olc_PixelGameEngine PGE;
 
 // local utility functions
-void drawline(int sx, int ex, int ny, olc_Pixel p) { for (int i = sx; i <= ex; i++) Draw(i, ny, p); };
+bool depthon();
+bool depthrun(const uint32_t* src, uint32_t fill, int32_t x, int32_t y, int32_t count, int32_t* i, int32_t* n);
+static inline uint32_t premultiply_px(uint32_t n);
+static inline uint32_t unpremultiply_px(uint32_t n);
+
+// fill the rectangle (x,y) to (x+w,y+h), already clipped to the draw target, a
+// row at a time with the span kernel for the current pixel mode
+void fillblock(int32_t x, int32_t y, int32_t w, int32_t h, olc_Pixel p)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || w <= 0 || h <= 0) return;
+
+    uint32_t* row = target->pixels + y * target->stride + x;
+
+    // a straight colour written as is into a premultiplied target has to be
+    // brought over first. ALPHA blends come out right in either representation
+    if(target->bPremultiplied && PGE.nPixelMode == olc_PIXELMODE_NORMAL)
+        p.n = premultiply_px(p.n);
+
+    switch(PGE.nPixelMode)
+    {
+        case olc_PIXELMODE_MASK:
+            // an opaque pixel is simply written
+            if(p.a != 255) break;
+            // fall through
+        case olc_PIXELMODE_NORMAL:
+            for(int32_t j = 0; j < h; j++, row += target->stride)
+                olc_Span.fill(row, p.n, w);
+            break;
+
+        case olc_PIXELMODE_ALPHA:
+            for(int32_t j = 0; j < h; j++, row += target->stride)
+                olc_Span.fillBlend(row, p, w, PGE.nBlendFactor);
+            break;
+
+        case olc_PIXELMODE_CUSTOM:
+            for(int32_t j = 0; j < h; j++, row += target->stride)
+                for(int32_t i = 0; i < w; i++)
+                    row[i] = PGE.funcPixelMode(x + i, y + j, p, olc_PixelRAW(row[i])).n;
+            break;
+
+        case olc_PIXELMODE_CUSTOM_SPAN:
+        {
+            // the span function wants a source run, so p is repeated once up front
+            olc_Pixel run[256];
+            int32_t n = (w < 256) ? w : 256;
+            for(int32_t i = 0; i < n; i++) run[i] = p;
+
+            for(int32_t j = 0; j < h; j++, row += target->stride)
+                for(int32_t i = 0; i < w; i += 256)
+                    PGE.funcSpanMode(x + i, y + j, run, (olc_Pixel*)(row + i), (w - i < 256) ? w - i : 256);
+            break;
+        }
+    }
+}
+
+// as fillblock, but under the depth test each row breaks up into the runs that pass it
+void fillrows(int32_t x, int32_t y, int32_t w, int32_t h, olc_Pixel p)
+{
+    if(PGE.pDrawTarget == NULL || w <= 0 || h <= 0) return;
+
+    if(!depthon())
+    {
+        fillblock(x, y, w, h, p);
+        return;
+    }
+
+    for(int32_t j = 0; j < h; j++)
+        for(int32_t i = 0, n; depthrun(NULL, p.n, x, y + j, w, &i, &n); i += n)
+            fillblock(x + i, y + j, n, 1, p);
+}
+
+void drawline(int sx, int ex, int ny, olc_Pixel p)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || ny < 0 || ny >= target->height) return;
+    if(sx < 0) sx = 0;
+    if(ex >= target->width) ex = target->width - 1;
+
+    fillrows(sx, ny, ex - sx + 1, 1, p);
+}
 void swap_int(int *a, int *b) { int temp = *a; *a = *b; *b = temp; }
 bool rol(uint32_t* pattern) { *pattern = (*pattern << 1) | (*pattern >> 31); return (*pattern & 1) ? true : false; }
+// floor(a / b) for b > 0
+int64_t floordiv64(int64_t a, int64_t b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); }
+// floor((a * b + c) / d) for a, b >= 0 and 0 < d < 2^62, with the remainder in
+// *r. a * b may pass 64 bits, so it is formed in two halves, but the quotient must not
+int64_t muldivfloor64(int64_t a, int64_t b, int64_t c, int64_t d, int64_t* r)
+{
+    uint64_t aL = (uint64_t)a & 0xFFFFFFFF, aH = (uint64_t)a >> 32;
+    uint64_t bL = (uint64_t)b & 0xFFFFFFFF, bH = (uint64_t)b >> 32;
+    uint64_t ll = aL * bL, lh = aL * bH, hl = aH * bL;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+    uint64_t lo = (ll & 0xFFFFFFFF) | (mid << 32);
+    uint64_t hi = aH * bH + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+    if(c >= 0)
+    {
+        hi += (lo + (uint64_t)c < lo) ? 1 : 0;
+        lo += (uint64_t)c;
+    }
+    else if(hi == 0 && lo < (uint64_t)-c)
+    {
+        // a small negative sum, which int64 holds as it is
+        int64_t q = floordiv64((int64_t)lo + c, d);
+        *r = (int64_t)lo + c - q * d;
+        return q;
+    }
+    else
+    {
+        hi -= (lo < (uint64_t)-c) ? 1 : 0;
+        lo -= (uint64_t)-c;
+    }
+
+    if(hi == 0 && lo <= INT64_MAX)
+    {
+        *r = (int64_t)(lo % (uint64_t)d);
+        return (int64_t)(lo / (uint64_t)d);
+    }
+
+    // long division a bit at a time, the high half being less than d
+    uint64_t q = 0, rem = hi % (uint64_t)d;
+    for(int32_t i = 63; i >= 0; i--)
+    {
+        rem = (rem << 1) | ((lo >> i) & 1);
+        if(rem >= (uint64_t)d) { rem -= (uint64_t)d; q |= (uint64_t)1 << i; }
+    }
+    *r = (int64_t)rem;
+    return (int64_t)q;
+}
+
+// is the depth test or depth writing on for drawing into the current target?
+bool depthon()
+{
+    return (PGE.bDepthTest || PGE.bDepthWrite) && PGE.pDrawTarget != NULL && olc_Sprite_GetRoot(PGE.pDrawTarget)->depth != NULL;
+}
+
+// find the next run of pixels, from *i of the count starting at (x,y) of the
+// draw target, that pass the depth test, writing their depth if that is on.
+// src holds the pixels about to be drawn, or NULL when they are all fill;
+// those the pixel mode would leave out neither pass nor write. False once
+// there are none left, otherwise the run is [*i, *i + *n)
+bool depthrun(const uint32_t* src, uint32_t fill, int32_t x, int32_t y, int32_t count, int32_t* i, int32_t* n)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    olc_Sprite* root = olc_Sprite_GetRoot(target);
+    size_t at = (size_t)(target->pixels - root->pixels) + (size_t)y * target->stride + x;
+    uint16_t* d16 = (uint16_t*)root->depth + at;
+    uint32_t* d32 = (uint32_t*)root->depth + at;
+    uint32_t z = PGE.nDrawDepth;
+    uint16_t z16 = (uint16_t)(z >> 16);
+
+    int32_t k = *i, start = -1;
+    for(; k < count; k++)
+    {
+        // MASK leaves out all but opaque pixels, ALPHA the fully transparent ones
+        uint32_t a = (src != NULL ? src[k] : fill) >> 24;
+        bool pass = !((PGE.nPixelMode == olc_PIXELMODE_MASK && a != 255) || (PGE.nPixelMode == olc_PIXELMODE_ALPHA && a == 0));
+        if(pass && PGE.bDepthTest)
+            pass = (root->nDepthBits == 16) ? (z16 <= d16[k]) : (z <= d32[k]);
+
+        if(!pass)
+        {
+            if(start >= 0) break;
+            continue;
+        }
+
+        if(start < 0) start = k;
+        if(PGE.bDepthWrite)
+        {
+            if(root->nDepthBits == 16) d16[k] = z16;
+            else                       d32[k] = z;
+        }
+    }
+
+    if(start < 0) return false;
+    *i = start;
+    *n = k - start;
+    return true;
+}
+
+// write the count pixels of src over the target pixels at dst, which start at
+// (x,y), in the current pixel mode. bPremultiplied tells how src is stored, so a
+// plain copy can bring it over to the draw target's representation
+void blitmode(uint32_t* dst, const uint32_t* src, int32_t count, int32_t x, int32_t y, bool bPremultiplied)
+{
+    switch(PGE.nPixelMode)
+    {
+        case olc_PIXELMODE_NORMAL:
+            if(bPremultiplied == PGE.pDrawTarget->bPremultiplied) olc_Span.copy(dst, src, count);
+            else if(bPremultiplied) for(int32_t i = 0; i < count; i++) dst[i] = unpremultiply_px(src[i]);
+            else                    for(int32_t i = 0; i < count; i++) dst[i] = premultiply_px(src[i]);
+            break;
+        case olc_PIXELMODE_MASK:   olc_Span.copyMasked(dst, src, count); break;
+        case olc_PIXELMODE_ALPHA:
+            if(bPremultiplied) olc_Span.blendPremul(dst, src, count, PGE.nBlendFactor);
+            else               olc_Span.blend(dst, src, count, PGE.nBlendFactor);
+            break;
+        case olc_PIXELMODE_CUSTOM:
+            for(int32_t i = 0; i < count; i++)
+                dst[i] = PGE.funcPixelMode(x + i, y, olc_PixelRAW(src[i]), olc_PixelRAW(dst[i])).n;
+            break;
+        case olc_PIXELMODE_CUSTOM_SPAN:
+            PGE.funcSpanMode(x, y, (const olc_Pixel*)src, (olc_Pixel*)dst, count);
+            break;
+    }
+}
+
+// as blitmode, but under the depth test only the runs of src that pass it
+void blitspan(uint32_t* dst, const uint32_t* src, int32_t count, int32_t x, int32_t y, bool bPremultiplied)
+{
+    if(!depthon())
+    {
+        blitmode(dst, src, count, x, y, bPremultiplied);
+        return;
+    }
+
+    for(int32_t i = 0, n; depthrun(src, 0, x, y, count, &i, &n); i += n)
+        blitmode(dst + i, src + i, n, x + i, y, bPremultiplied);
+}
+
+// draw the region (ox,oy) to (ox+w,oy+h) of sprite at (x,y), unscaled, a row at
+// a time through the span kernels. The region is intersected with both the
+// sprite and the draw target up front, so anything outside either costs nothing,
+// and flips only change where each source row starts and which way it steps.
+void blitrows(int32_t x, int32_t y, olc_Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint8_t flip)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || sprite == NULL) return;
+
+    // source column of destination column i is sx0 + i * sxm, likewise for rows
+    int32_t sxm = (flip & olc_SPRITEFLIP_HORIZ) ? -1 : 1;
+    int32_t sym = (flip & olc_SPRITEFLIP_VERT)  ? -1 : 1;
+    int32_t sx0 = (sxm < 0) ? ox + w - 1 : ox;
+    int32_t sy0 = (sym < 0) ? oy + h - 1 : oy;
+
+    // columns i of the region that land inside both the target and the sprite
+    int32_t i0 = 0, i1 = w;
+    if(x + i0 < 0) i0 = -x;
+    if(x + i1 > target->width) i1 = target->width - x;
+    if(sxm > 0)
+    {
+        if(sx0 + i0 < 0) i0 = -sx0;
+        if(sx0 + i1 > sprite->width) i1 = sprite->width - sx0;
+    }
+    else
+    {
+        if(sx0 - i0 >= sprite->width) i0 = sx0 - sprite->width + 1;
+        if(sx0 - i1 < -1) i1 = sx0 + 1;
+    }
+
+    // and the same for rows j
+    int32_t j0 = 0, j1 = h;
+    if(y + j0 < 0) j0 = -y;
+    if(y + j1 > target->height) j1 = target->height - y;
+    if(sym > 0)
+    {
+        if(sy0 + j0 < 0) j0 = -sy0;
+        if(sy0 + j1 > sprite->height) j1 = sprite->height - sy0;
+    }
+    else
+    {
+        if(sy0 - j0 >= sprite->height) j0 = sy0 - sprite->height + 1;
+        if(sy0 - j1 < -1) j1 = sy0 + 1;
+    }
+
+    if(i0 >= i1 || j0 >= j1) return;
+
+    int32_t count = i1 - i0;
+    uint32_t* dst = target->pixels + (y + j0) * target->stride + x + i0;
+    const uint32_t* src = sprite->pixels + (sy0 + j0 * sym) * sprite->stride + sx0 + i0 * sxm;
+    ptrdiff_t srcStep = (ptrdiff_t)sym * sprite->stride;
+
+    // in MASK mode only the sprite's opaque runs are copied, the transparent gaps
+    // between them are never read. Not while drawing a sprite into itself though,
+    // as its runs would go stale part way through, nor under the depth test
+    olc_SpriteSpans* spans = NULL;
+    if(PGE.nPixelMode == olc_PIXELMODE_MASK && olc_Sprite_GetRoot(sprite) != olc_Sprite_GetRoot(target) && !depthon())
+        spans = olc_Sprite_GetSpans(sprite);
+
+    if(spans != NULL)
+    {
+        // the source columns that are drawn, [cs, ce)
+        int32_t cs = (sxm > 0) ? sx0 + i0 : sx0 - i1 + 1;
+        int32_t ce = (sxm > 0) ? sx0 + i1 : sx0 - i0 + 1;
+
+        for(int32_t j = j0; j < j1; j++, dst += target->stride)
+        {
+            int32_t sy = sy0 + j * sym;
+            const uint32_t* row = sprite->pixels + sy * sprite->stride;
+
+            for(int32_t r = spans->rows[sy]; r < spans->rows[sy + 1]; r++)
+            {
+                int32_t a = spans->runs[r].start, b = a + spans->runs[r].length;
+                if(a >= ce) break;
+                if(a < cs) a = cs;
+                if(b > ce) b = ce;
+                if(a >= b) continue;
+
+                if(sxm > 0)
+                    memcpy(dst + (a - sx0 - i0), row + a, sizeof(uint32_t) * (b - a));
+                else
+                    for(int32_t sx = a; sx < b; sx++) dst[sx0 - sx - i0] = row[sx];
+            }
+        }
+        return;
+    }
+
+    // mirrored rows are reversed a chunk at a time, so they can still go through the kernels
+    uint32_t reversed[256];
+
+    for(int32_t j = j0; j < j1; j++, dst += target->stride, src += srcStep)
+    {
+        for(int32_t n = 0; n < count; n += 256)
+        {
+            int32_t chunk = (count - n < 256) ? count - n : 256;
+            const uint32_t* run = src + n;
+            if(sxm < 0)
+            {
+                for(int32_t i = 0; i < chunk; i++) reversed[i] = src[-(n + i)];
+                run = reversed;
+            }
+
+            blitspan(dst + n, run, chunk, x + i0 + n, y + j, sprite->bPremultiplied);
+        }
+    }
+}
+
+// draw the region (ox,oy) to (ox+w,oy+h) of sprite at (x,y), each pixel blown up
+// to a scale x scale block. Each source row is expanded once into a scratch span,
+// a chunk at a time, which is then written to all scale target rows it covers
+void blitscaled(int32_t x, int32_t y, olc_Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, int32_t scale, uint8_t flip)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || sprite == NULL || scale < 1) return;
+
+    // source column of region column i is sx0 + i * sxm, likewise for rows
+    int32_t sxm = (flip & olc_SPRITEFLIP_HORIZ) ? -1 : 1;
+    int32_t sym = (flip & olc_SPRITEFLIP_VERT)  ? -1 : 1;
+    int32_t sx0 = (sxm < 0) ? ox + w - 1 : ox;
+    int32_t sy0 = (sym < 0) ? oy + h - 1 : oy;
+
+    // region columns i that lie inside the sprite
+    int32_t i0 = 0, i1 = w;
+    if(sxm > 0)
+    {
+        if(sx0 + i0 < 0) i0 = -sx0;
+        if(sx0 + i1 > sprite->width) i1 = sprite->width - sx0;
+    }
+    else
+    {
+        if(sx0 - i0 >= sprite->width) i0 = sx0 - sprite->width + 1;
+        if(sx0 - i1 < -1) i1 = sx0 + 1;
+    }
+
+    // and the same for rows j
+    int32_t j0 = 0, j1 = h;
+    if(sym > 0)
+    {
+        if(sy0 + j0 < 0) j0 = -sy0;
+        if(sy0 + j1 > sprite->height) j1 = sprite->height - sy0;
+    }
+    else
+    {
+        if(sy0 - j0 >= sprite->height) j0 = sy0 - sprite->height + 1;
+        if(sy0 - j1 < -1) j1 = sy0 + 1;
+    }
+
+    if(i0 >= i1 || j0 >= j1) return;
+
+    // scaled up columns I and rows J that also land inside the target. These
+    // are 64 bit, as i1 * scale can pass the int32 range before it is clipped
+    int64_t I0 = (int64_t)i0 * scale, I1 = (int64_t)i1 * scale;
+    int64_t J0 = (int64_t)j0 * scale, J1 = (int64_t)j1 * scale;
+    if(x + I0 < 0) I0 = -(int64_t)x;
+    if(x + I1 > target->width) I1 = (int64_t)target->width - x;
+    if(y + J0 < 0) J0 = -(int64_t)y;
+    if(y + J1 > target->height) J1 = (int64_t)target->height - y;
+
+    if(I0 >= I1 || J0 >= J1) return;
+
+    uint32_t expanded[1024];
+
+    for(int64_t j = J0 / scale; j * scale < J1; j++)
+    {
+        const uint32_t* row = sprite->pixels + (sy0 + j * sym) * sprite->stride;
+        int64_t Js = (j * scale > J0) ? j * scale : J0;
+        int64_t Je = ((j + 1) * scale < J1) ? (j + 1) * scale : J1;
+
+        for(int64_t n = I0; n < I1; n += 1024)
+        {
+            int32_t chunk = (I1 - n < 1024) ? (int32_t)(I1 - n) : 1024;
+
+            // repeat each source pixel across the columns it covers
+            for(int64_t I = n, k = 0; I < n + chunk; )
+            {
+                int64_t i = I / scale;
+                int64_t e = (i + 1) * scale;
+                if(e > n + chunk) e = n + chunk;
+                uint32_t p = row[sx0 + i * sxm];
+                for(; I < e; I++) expanded[k++] = p;
+            }
+
+            // x + n and y + J are on the target, so back inside int32
+            for(int64_t J = Js; J < Je; J++)
+            {
+                uint32_t* dst = target->pixels + (y + J) * target->stride + x + n;
+                blitspan(dst, expanded, chunk, (int32_t)(x + n), (int32_t)(y + J), sprite->bPremultiplied);
+            }
+        }
+    }
+}
 
 // init vector struct
 void vector_init(vector* v)
@@ -31,7 +440,7 @@ void vector_init(vector* v)
 void vector_resize(vector* v, size_t capacity)
 {
     // attempt reallocation
-    void** items = realloc(v->items, sizeof(void *) * capacity);
+    void** items = olc_Realloc(v->items, sizeof(void *) * capacity, olc_ALLOC_CONTAINERS);
     
     // if success
     if(items != NULL)
@@ -54,7 +463,7 @@ void vector_free(vector* v)
     }
 
     // free the items array
-    free(v->items);
+    olc_Free(v->items);
 
     // reset vector variables
     v->capacity = 0;
@@ -147,6 +556,161 @@ void vector_remove(vector* v, size_t index)
 size_t vector_size(vector* v)
 { return v->size; }
 
+// O------------------------------------------------------------------------------O
+// | Allocator - Every engine allocation, tagged by what it is used for           |
+// O------------------------------------------------------------------------------O
+
+// every block carries its size and category in front of it, so frees and
+// reallocations can be accounted without the caller remembering either
+#define olc_nAllocHeader 16
+
+static void* default_alloc(void* user, void* p, size_t oldSize, size_t newSize, uint32_t category)
+{
+    UNUSED(user); UNUSED(oldSize); UNUSED(category);
+
+    if(newSize == 0)
+    {
+        free(p);
+        return NULL;
+    }
+
+    return realloc(p, newSize);
+}
+
+static olc_Allocator allocator = { &default_alloc, NULL };
+static olc_AllocStats allocStats[olc_ALLOC_CATEGORIES];
+static const char* allocNames[olc_ALLOC_CATEGORIES] = { "general", "sprite pixels", "decal instances", "containers", "textures" };
+static bool bAllocDebug = false;
+static bool bAllocInFrame = false;
+static uint32_t nFrameAllocations = 0;
+static uint32_t nLastFrameAllocations = 0;
+
+// update the statistics of a category after a block changed size
+static void alloc_record(uint32_t category, size_t oldSize, size_t newSize)
+{
+    olc_AllocStats* stats = &allocStats[category];
+
+    stats->nBytes = stats->nBytes - oldSize + newSize;
+    if(stats->nBytes > stats->nPeakBytes) stats->nPeakBytes = stats->nBytes;
+
+    if(oldSize == 0) stats->nAllocations++;
+    if(newSize == 0) stats->nAllocations--;
+    if(newSize == 0) return;
+
+    stats->nTotalAllocations++;
+
+    if(bAllocInFrame)
+    {
+        nFrameAllocations++;
+        if(bAllocDebug)
+            fprintf(stderr, "Allocation of %zu bytes (%s) during frame.\n", newSize, allocNames[category]);
+    }
+}
+
+void olc_SetAllocator(olc_Allocator a)
+{
+    allocator.funcAlloc = (a.funcAlloc == NULL) ? &default_alloc : a.funcAlloc;
+    allocator.user = (a.funcAlloc == NULL) ? NULL : a.user;
+}
+
+olc_AllocStats olc_GetAllocStats(uint32_t category)
+{
+    if(category < olc_ALLOC_CATEGORIES)
+        return allocStats[category];
+
+    olc_AllocStats none = { 0, 0, 0, 0 };
+    return none;
+}
+
+void olc_SetAllocDebug(bool bEnable)
+{ bAllocDebug = bEnable; }
+
+uint32_t olc_GetFrameAllocations()
+{ return nLastFrameAllocations; }
+
+void* olc_Malloc(size_t size, uint32_t category)
+{ return olc_Realloc(NULL, size, category); }
+
+void* olc_Calloc(size_t count, size_t size, uint32_t category)
+{
+    if(size != 0 && count > SIZE_MAX / size) return NULL;
+
+    void* p = olc_Malloc(count * size, category);
+    if(p != NULL) memset(p, 0, count * size);
+
+    return p;
+}
+
+void* olc_Realloc(void* p, size_t size, uint32_t category)
+{
+    if(category >= olc_ALLOC_CATEGORIES) category = olc_ALLOC_GENERAL;
+
+    if(size == 0)
+    {
+        olc_Free(p);
+        return NULL;
+    }
+
+    size_t oldSize = 0;
+    uint32_t oldCategory = category;
+    uint8_t* block = NULL;
+
+    if(p != NULL)
+    {
+        block = (uint8_t*)p - olc_nAllocHeader;
+        oldSize = ((size_t*)block)[0];
+        oldCategory = (uint32_t)((size_t*)block)[1];
+    }
+
+    if(size > SIZE_MAX - olc_nAllocHeader) return NULL;
+
+    block = (uint8_t*)allocator.funcAlloc(allocator.user, block, (oldSize != 0) ? oldSize + olc_nAllocHeader : 0, size + olc_nAllocHeader, category);
+    if(block == NULL) return NULL;
+
+    ((size_t*)block)[0] = size;
+    ((size_t*)block)[1] = category;
+
+    if(oldCategory != category)
+    {
+        alloc_record(oldCategory, oldSize, 0);
+        oldSize = 0;
+    }
+    alloc_record(category, oldSize, size);
+
+    return block + olc_nAllocHeader;
+}
+
+void olc_Free(void* p)
+{
+    if(p == NULL) return;
+
+    uint8_t* block = (uint8_t*)p - olc_nAllocHeader;
+    size_t size = ((size_t*)block)[0];
+    uint32_t category = (uint32_t)((size_t*)block)[1];
+
+    allocator.funcAlloc(allocator.user, block, size + olc_nAllocHeader, 0, category);
+    alloc_record(category, size, 0);
+}
+
+// allocate size bytes starting on an alignment byte boundary (power of two)
+void* olc_AlignedAlloc(size_t size, size_t alignment, uint32_t category)
+{
+    // over allocate, and stash the original block just before the aligned one
+    void* block = olc_Malloc(size + alignment - 1 + sizeof(void*), category);
+    if(block == NULL) return NULL;
+
+    uintptr_t aligned = ((uintptr_t)block + sizeof(void*) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    ((void**)aligned)[-1] = block;
+
+    return (void*)aligned;
+}
+
+// release memory obtained from olc_AlignedAlloc
+void olc_AlignedFree(void* p)
+{
+    if(p != NULL) olc_Free(((void**)p)[-1]);
+}
+
 
 olc_Pixel olc_PixelDefault()
 { return olc_PixelRAW(olc_nDefaultPixel); }
@@ -188,95 +752,708 @@ void olc_PixelColourInit()
 }
 
 // O------------------------------------------------------------------------------O
-// | olc_vX2d - A generic 2D vector type                                          |
+// | olc_SpanKernels - Inner loops over runs of 32-Bit pixels                     |
 // O------------------------------------------------------------------------------O
 
-olc_vi2d olc_VI2D(int x, int y) { olc_vi2d ret; ret.x = x; ret.y = y; return ret; }
-olc_vf2d olc_VF2D(float x, float y) { olc_vf2d ret; ret.x = x; ret.y = y; return ret; }
-olc_vd2d olc_VD2D(double x, double y) { olc_vd2d ret; ret.x = x; ret.y = y; return ret; }
+#if !defined(OLC_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+    #define OLC_SIMD_X86
+    #include <immintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define olc_TARGET_SSE2 __attribute__((target("sse2")))
+        #define olc_TARGET_AVX2 __attribute__((target("avx2")))
+    #else
+        #define olc_TARGET_SSE2
+        #define olc_TARGET_AVX2
+    #endif
+#endif
 
+// Plain C kernels, also used for the tails the vector kernels leave behind
 
-// O------------------------------------------------------------------------------O
-// | olc::Sprite - An image represented by a 2D array of olc::Pixel               |
-// O------------------------------------------------------------------------------O
+void span_fill_c(uint32_t* dst, uint32_t p, int32_t count)
+{ for(int32_t i = 0; i < count; i++) dst[i] = p; }
 
-olc_Sprite* olc_Sprite_Create(int32_t w, int32_t h)
-{
-    olc_Sprite* sprite;
+void span_copy(uint32_t* dst, const uint32_t* src, int32_t count)
+{ if(count > 0) memmove(dst, src, sizeof(uint32_t) * count); }
 
-    sprite = (olc_Sprite*)malloc(sizeof(olc_Sprite));
-    if(sprite == NULL)
+void span_copy_masked_c(uint32_t* dst, const uint32_t* src, int32_t count)
+{ for(int32_t i = 0; i < count; i++) if((src[i] >> 24) == 0xFF) dst[i] = src[i]; }
+
+// blend source pixel s over destination pixel d. The weight is s's alpha scaled
+// by the 8.8 fixed-point blend factor nBlend (0 to 256). Colour channels are
+// lerped, and the result alpha is the usual "over" coverage a + d.a * (1 - a),
+// so opaque targets stay opaque. Every channel is rounded exactly.
+static inline uint32_t blend_px(uint32_t s, uint32_t d, uint32_t nBlend)
+{
+    uint32_t a = ((s >> 24) * nBlend + 128) >> 8, c = 255 - a, r = 0;
+    s |= 0xFF000000;
+    for(int32_t sh = 0; sh < 32; sh += 8)
     {
-        fprintf(stderr, "Failed to allcoate ram for sprite.\n");
-        exit(EXIT_FAILURE);
+        uint32_t t = ((s >> sh) & 0xFF) * a + ((d >> sh) & 0xFF) * c + 128;
+        r |= ((t + (t >> 8)) >> 8) << sh;
     }
+    return r;
+}
 
-    sprite->width = w;
-    sprite->height = h;
-    sprite->pixels = (uint32_t*)calloc(sizeof(uint32_t), w * h);
-    sprite->modeSample = olc_SPRITEMODE_NORMAL; // Good Catch! Thanks Tarry
+void span_blend_c(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend)
+{ for(int32_t i = 0; i < count; i++) dst[i] = blend_px(src[i], dst[i], nBlend); }
 
-    if(sprite->pixels == NULL)
+void span_fill_blend_c(uint32_t* dst, olc_Pixel p, int32_t count, uint32_t nBlend)
+{ for(int32_t i = 0; i < count; i++) dst[i] = blend_px(p.n, dst[i], nBlend); }
+
+// blend premultiplied source pixel s over destination pixel d. s is scaled by the
+// 8.8 fixed-point blend factor nBlend, then d is added in weighted by what s
+// leaves uncovered, so unlike blend_px the source needs no multiply at full blend
+static inline uint32_t blend_px_premul(uint32_t s, uint32_t d, uint32_t nBlend)
+{
+    uint32_t r = 0;
+    if(nBlend < 256)
+        for(int32_t sh = 0; sh < 32; sh += 8) r |= ((((s >> sh) & 0xFF) * nBlend + 128) >> 8) << sh;
+    else
+        r = s;
+
+    uint32_t c = 255 - (r >> 24);
+    s = r; r = 0;
+    for(int32_t sh = 0; sh < 32; sh += 8)
     {
-        fprintf(stderr, "Failed to allocate ram for sprite pixel data.\n"); // Gusgo Spellcheck PRO+, coming to Google soon!
-        exit(EXIT_FAILURE);
+        uint32_t t = ((d >> sh) & 0xFF) * c + 128;
+        uint32_t v = ((s >> sh) & 0xFF) + ((t + (t >> 8)) >> 8);
+        r |= (v > 255 ? 255 : v) << sh;
     }
+    return r;
+}
 
-    return sprite;
+void span_blend_premul_c(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend)
+{ for(int32_t i = 0; i < count; i++) dst[i] = blend_px_premul(src[i], dst[i], nBlend); }
+
+// exact round(x * y / 255) for bytes x and y
+#define olc_MUL255(x, y) ((((uint32_t)(x) * (uint32_t)(y) + 128) * 257) >> 16)
+
+// straight alpha to premultiplied alpha, colour channels are scaled by alpha
+static inline uint32_t premultiply_px(uint32_t n)
+{
+    olc_Pixel p = olc_PixelRAW(n);
+    return olc_PixelRGBA(olc_MUL255(p.r, p.a), olc_MUL255(p.g, p.a), olc_MUL255(p.b, p.a), p.a).n;
 }
 
-olc_Sprite* olc_Sprite_Load(const char *sImageFile)
+// premultiplied alpha back to straight alpha, rounded. Colour under zero alpha is lost
+static inline uint32_t unpremultiply_px(uint32_t n)
 {
-    return olc_Sprite_LoadFromFile(sImageFile);
+    olc_Pixel p = olc_PixelRAW(n);
+    if(p.a == 0) return 0;
+    if(p.a == 255) return n;
+
+    uint32_t r = (p.r * 255 + p.a / 2) / p.a, g = (p.g * 255 + p.a / 2) / p.a, b = (p.b * 255 + p.a / 2) / p.a;
+    return olc_PixelRGBA(r > 255 ? 255 : r, g > 255 ? 255 : g, b > 255 ? 255 : b, p.a).n;
 }
 
-void olc_Sprite_Destroy(olc_Sprite* sprite)
+void span_copy_tinted_c(uint32_t* dst, const uint32_t* src, int32_t count, olc_Pixel tint)
 {
-    free(sprite->pixels);
-    sprite->pixels = NULL;
-    
-    free(sprite);
-    sprite = NULL;
+    for(int32_t i = 0; i < count; i++)
+    {
+        olc_Pixel p = olc_PixelRAW(src[i]);
+        dst[i] = olc_PixelRGBA(olc_MUL255(p.r, tint.r), olc_MUL255(p.g, tint.g), olc_MUL255(p.b, tint.b), olc_MUL255(p.a, tint.a)).n;
+    }
 }
 
-olc_Sprite* olc_Sprite_LoadFromPGESprFile(const char *sImageFile)
+// blend of a and b with weight w (0 to 256) on b, per channel
+static inline uint32_t lerp_px(uint32_t a, uint32_t b, uint32_t w)
 {
-    int32_t width;
-    int32_t height;
-    uint32_t* pixels;
-    
-    FILE* fp = fopen(sImageFile, "r");
-    if(fp)
+    uint32_t rb = ((a & 0x00FF00FF) * (256 - w) + (b & 0x00FF00FF) * w) >> 8;
+    uint32_t ga = (((a >> 8) & 0x00FF00FF) * (256 - w) + ((b >> 8) & 0x00FF00FF) * w) >> 8;
+    return (rb & 0x00FF00FF) | ((ga & 0x00FF00FF) << 8);
+}
+
+void span_bilerp_c(uint32_t* dst, const uint32_t* taps, const uint32_t* weights, int32_t count)
+{
+    for(int32_t i = 0; i < count; i++, taps += 4)
     {
-        fread(&width, sizeof(int32_t), 1, fp);
-        fread(&height, sizeof(int32_t), 1, fp);
+        uint32_t wx = weights[i] & 0xFFFF, wy = weights[i] >> 16;
+        dst[i] = lerp_px(lerp_px(taps[0], taps[1], wx), lerp_px(taps[2], taps[3], wx), wy);
+    }
+}
 
-        pixels = malloc(width*height*sizeof(uint32_t));
-        if(pixels == NULL)
-        {
-            fprintf(stderr, "Error loading allocating pixel data in PGESprite Loader.\n");
-            exit(EXIT_FAILURE);
-        }
+void span_downsample_c(uint32_t* dst, const uint32_t* row0, const uint32_t* row1, int32_t count)
+{
+    for(int32_t i = 0; i < count; i++, row0 += 2, row1 += 2)
+    {
+        // two channels per word, each sum of four bytes fits its 16 bits
+        uint32_t rb = (row0[0] & 0x00FF00FF) + (row0[1] & 0x00FF00FF) + (row1[0] & 0x00FF00FF) + (row1[1] & 0x00FF00FF) + 0x00020002;
+        uint32_t ga = ((row0[0] >> 8) & 0x00FF00FF) + ((row0[1] >> 8) & 0x00FF00FF) + ((row1[0] >> 8) & 0x00FF00FF) + ((row1[1] >> 8) & 0x00FF00FF) + 0x00020002;
+        dst[i] = ((rb >> 2) & 0x00FF00FF) | (((ga >> 2) & 0x00FF00FF) << 8);
+    }
+}
 
-        fread(pixels, sizeof(uint32_t), width*height, fp);
+#ifdef OLC_SIMD_X86
 
-        olc_Sprite* sprite = olc_Sprite_Create(width, height);
+// SSE2, 4 pixels per step
+
+olc_TARGET_SSE2 void span_fill_sse2(uint32_t* dst, uint32_t p, int32_t count)
+{
+    __m128i v = _mm_set1_epi32((int)p);
+    int32_t i = 0;
+    for(; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i*)(dst + i), v);
+    span_fill_c(dst + i, p, count - i);
+}
+
+olc_TARGET_SSE2 void span_copy_masked_sse2(uint32_t* dst, const uint32_t* src, int32_t count)
+{
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    int32_t i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i m = _mm_cmpeq_epi32(_mm_and_si128(s, alpha), alpha);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_and_si128(m, s), _mm_andnot_si128(m, d)));
+    }
+    span_copy_masked_c(dst + i, src + i, count - i);
+}
+
+// blend two pixels held as 16-bit lanes, the same arithmetic as blend_px
+olc_TARGET_SSE2 static inline __m128i blend_px_sse2(__m128i s, __m128i d, __m128i blend)
+{
+    // weight a = s.a * blend, copied to all four channels of each pixel
+    __m128i a = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s, blend), _mm_set1_epi16(128)), 8);
+    a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0xFF), 0xFF);
+    __m128i c = _mm_sub_epi16(_mm_set1_epi16(255), a);
+    // the source alpha lane takes part as fully opaque
+    s = _mm_or_si128(s, _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+    __m128i t = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, c)), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+olc_TARGET_SSE2 void span_blend_sse2(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i blend = _mm_set1_epi16((short)nBlend);
+    int32_t i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i lo = blend_px_sse2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), blend);
+        __m128i hi = blend_px_sse2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), blend);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    span_blend_c(dst + i, src + i, count - i, nBlend);
+}
+
+olc_TARGET_SSE2 void span_fill_blend_sse2(uint32_t* dst, olc_Pixel p, int32_t count, uint32_t nBlend)
+{
+    // the source term is the same for every pixel, so it is worked out once
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t a = ((uint32_t)p.a * nBlend + 128) >> 8;
+    const __m128i c = _mm_set1_epi16((short)(255 - a));
+    const __m128i s = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)(p.n | 0xFF000000)), zero), _mm_set1_epi16((short)a)), _mm_set1_epi16(128));
+    int32_t i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i lo = _mm_add_epi16(s, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), c));
+        __m128i hi = _mm_add_epi16(s, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), c));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    span_fill_blend_c(dst + i, p, count - i, nBlend);
+}
+
+// blend two premultiplied pixels held as 16-bit lanes, the same arithmetic as blend_px_premul
+olc_TARGET_SSE2 static inline __m128i blend_px_premul_sse2(__m128i s, __m128i d, __m128i blend, bool bScale)
+{
+    if(bScale) s = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s, blend), _mm_set1_epi16(128)), 8);
+    __m128i c = _mm_sub_epi16(_mm_set1_epi16(255), _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF));
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(d, c), _mm_set1_epi16(128));
+    return _mm_add_epi16(s, _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8));
+}
+
+olc_TARGET_SSE2 void span_blend_premul_sse2(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i blend = _mm_set1_epi16((short)nBlend);
+    const bool bScale = nBlend < 256;
+    int32_t i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i lo = blend_px_premul_sse2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), blend, bScale);
+        __m128i hi = blend_px_premul_sse2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), blend, bScale);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    span_blend_premul_c(dst + i, src + i, count - i, nBlend);
+}
+
+// exact round(x * y / 255) on 16-bit lanes holding bytes
+olc_TARGET_SSE2 static inline __m128i mul255_sse2(__m128i x, __m128i y)
+{
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(x, y), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+olc_TARGET_SSE2 void span_copy_tinted_sse2(uint32_t* dst, const uint32_t* src, int32_t count, olc_Pixel tint)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i t = _mm_unpacklo_epi8(_mm_set1_epi32((int)tint.n), zero);
+    int32_t i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = mul255_sse2(_mm_unpacklo_epi8(s, zero), t);
+        __m128i hi = mul255_sse2(_mm_unpackhi_epi8(s, zero), t);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    span_copy_tinted_c(dst + i, src + i, count - i, tint);
+}
+
+olc_TARGET_SSE2 void span_bilerp_sse2(uint32_t* dst, const uint32_t* taps, const uint32_t* weights, int32_t count)
+{
+    // one pixel per step: the top taps are lerped in one register and the bottom
+    // taps in another, then the two results are lerped the same way
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(256);
+    for(int32_t i = 0; i < count; i++, taps += 4)
+    {
+        __m128i t = _mm_loadu_si128((const __m128i*)taps);
+        __m128i wx = _mm_set1_epi16((short)(weights[i] & 0xFFFF));
+        __m128i wy = _mm_set1_epi16((short)(weights[i] >> 16));
+        __m128i mx = _mm_unpacklo_epi64(_mm_sub_epi16(full, wx), wx);
+        __m128i my = _mm_unpacklo_epi64(_mm_sub_epi16(full, wy), wy);
+
+        __m128i top = _mm_mullo_epi16(_mm_unpacklo_epi8(t, zero), mx);
+        __m128i bot = _mm_mullo_epi16(_mm_unpackhi_epi8(t, zero), mx);
+        top = _mm_srli_epi16(_mm_add_epi16(top, _mm_srli_si128(top, 8)), 8);
+        bot = _mm_srli_epi16(_mm_add_epi16(bot, _mm_srli_si128(bot, 8)), 8);
+
+        __m128i v = _mm_mullo_epi16(_mm_unpacklo_epi64(top, bot), my);
+        v = _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_si128(v, 8)), 8);
+        dst[i] = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(v, zero));
+    }
+}
+
+olc_TARGET_SSE2 void span_downsample_sse2(uint32_t* dst, const uint32_t* row0, const uint32_t* row1, int32_t count)
+{
+    // two output pixels per step, from four pixels of each row
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(2);
+    int32_t i = 0;
+    for(; i + 2 <= count; i += 2)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(row0 + 2 * i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(row1 + 2 * i));
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+        __m128i s = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi)), round);
+        _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(_mm_srli_epi16(s, 2), zero));
+    }
+    span_downsample_c(dst + i, row0 + 2 * i, row1 + 2 * i, count - i);
+}
+
+// AVX2, 8 pixels per step
+
+olc_TARGET_AVX2 void span_fill_avx2(uint32_t* dst, uint32_t p, int32_t count)
+{
+    __m256i v = _mm256_set1_epi32((int)p);
+    int32_t i = 0;
+    for(; i + 8 <= count; i += 8) _mm256_storeu_si256((__m256i*)(dst + i), v);
+    span_fill_c(dst + i, p, count - i);
+}
+
+olc_TARGET_AVX2 void span_copy_masked_avx2(uint32_t* dst, const uint32_t* src, int32_t count)
+{
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+    int32_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i m = _mm256_cmpeq_epi32(_mm256_and_si256(s, alpha), alpha);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(d, s, m));
+    }
+    span_copy_masked_c(dst + i, src + i, count - i);
+}
+
+// blend four pixels held as 16-bit lanes, the same arithmetic as blend_px
+olc_TARGET_AVX2 static inline __m256i blend_px_avx2(__m256i s, __m256i d, __m256i blend)
+{
+    __m256i a = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s, blend), _mm256_set1_epi16(128)), 8);
+    a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(a, 0xFF), 0xFF);
+    __m256i c = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+    s = _mm256_or_si256(s, _mm256_set1_epi64x((long long)0x00FF000000000000ULL));
+    __m256i t = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, c)), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+olc_TARGET_AVX2 void span_blend_avx2(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i blend = _mm256_set1_epi16((short)nBlend);
+    int32_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i lo = blend_px_avx2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), blend);
+        __m256i hi = blend_px_avx2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), blend);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    span_blend_c(dst + i, src + i, count - i, nBlend);
+}
+
+olc_TARGET_AVX2 void span_fill_blend_avx2(uint32_t* dst, olc_Pixel p, int32_t count, uint32_t nBlend)
+{
+    // the source term is the same for every pixel, so it is worked out once
+    const __m256i zero = _mm256_setzero_si256();
+    uint32_t a = ((uint32_t)p.a * nBlend + 128) >> 8;
+    const __m256i c = _mm256_set1_epi16((short)(255 - a));
+    const __m256i s = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(_mm256_set1_epi32((int)(p.n | 0xFF000000)), zero), _mm256_set1_epi16((short)a)), _mm256_set1_epi16(128));
+    int32_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i lo = _mm256_add_epi16(s, _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), c));
+        __m256i hi = _mm256_add_epi16(s, _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), c));
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    span_fill_blend_c(dst + i, p, count - i, nBlend);
+}
+
+// blend four premultiplied pixels held as 16-bit lanes, the same arithmetic as blend_px_premul
+olc_TARGET_AVX2 static inline __m256i blend_px_premul_avx2(__m256i s, __m256i d, __m256i blend, bool bScale)
+{
+    if(bScale) s = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s, blend), _mm256_set1_epi16(128)), 8);
+    __m256i c = _mm256_sub_epi16(_mm256_set1_epi16(255), _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xFF), 0xFF));
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(d, c), _mm256_set1_epi16(128));
+    return _mm256_add_epi16(s, _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8));
+}
+
+olc_TARGET_AVX2 void span_blend_premul_avx2(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i blend = _mm256_set1_epi16((short)nBlend);
+    const bool bScale = nBlend < 256;
+    int32_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i lo = blend_px_premul_avx2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), blend, bScale);
+        __m256i hi = blend_px_premul_avx2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), blend, bScale);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    span_blend_premul_c(dst + i, src + i, count - i, nBlend);
+}
+
+olc_TARGET_AVX2 void span_copy_tinted_avx2(uint32_t* dst, const uint32_t* src, int32_t count, olc_Pixel tint)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i t = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)tint.n), zero);
+    const __m256i round = _mm256_set1_epi16(128);
+    int32_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), t), round);
+        __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), t), round);
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    span_copy_tinted_c(dst + i, src + i, count - i, tint);
+}
+
+olc_TARGET_AVX2 void span_bilerp_avx2(uint32_t* dst, const uint32_t* taps, const uint32_t* weights, int32_t count)
+{
+    // as the SSE2 kernel, with a pixel in each 128-bit lane
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i full = _mm256_set1_epi16(256);
+    int32_t i = 0;
+    for(; i + 2 <= count; i += 2, taps += 8)
+    {
+        __m256i t = _mm256_loadu_si256((const __m256i*)taps);
+        __m256i w = _mm256_set_m128i(_mm_set1_epi32((int)weights[i + 1]), _mm_set1_epi32((int)weights[i]));
+        __m256i wx = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(w, 0x00), 0x00);
+        __m256i wy = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(w, 0x55), 0x55);
+        __m256i mx = _mm256_unpacklo_epi64(_mm256_sub_epi16(full, wx), wx);
+        __m256i my = _mm256_unpacklo_epi64(_mm256_sub_epi16(full, wy), wy);
+
+        __m256i top = _mm256_mullo_epi16(_mm256_unpacklo_epi8(t, zero), mx);
+        __m256i bot = _mm256_mullo_epi16(_mm256_unpackhi_epi8(t, zero), mx);
+        top = _mm256_srli_epi16(_mm256_add_epi16(top, _mm256_srli_si256(top, 8)), 8);
+        bot = _mm256_srli_epi16(_mm256_add_epi16(bot, _mm256_srli_si256(bot, 8)), 8);
+
+        __m256i v = _mm256_mullo_epi16(_mm256_unpacklo_epi64(top, bot), my);
+        v = _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_si256(v, 8)), 8);
+        v = _mm256_packus_epi16(v, zero);
+        dst[i] = (uint32_t)_mm256_extract_epi32(v, 0);
+        dst[i + 1] = (uint32_t)_mm256_extract_epi32(v, 4);
+    }
+    span_bilerp_c(dst + i, taps, weights + i, count - i);
+}
+
+olc_TARGET_AVX2 void span_downsample_avx2(uint32_t* dst, const uint32_t* row0, const uint32_t* row1, int32_t count)
+{
+    // as the SSE2 kernel, two output pixels in each 128-bit lane
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi16(2);
+    int32_t i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(row0 + 2 * i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(row1 + 2 * i));
+        __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+        __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+        __m256i s = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi)), round);
+        s = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(s, 2), zero), 0x08);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm256_castsi256_si128(s));
+    }
+    span_downsample_c(dst + i, row0 + 2 * i, row1 + 2 * i, count - i);
+}
+
+#endif
+
+olc_SpanKernels olc_Span = { "C", &span_fill_c, &span_copy, &span_copy_masked_c, &span_blend_c, &span_fill_blend_c, &span_copy_tinted_c, &span_blend_premul_c, &span_bilerp_c, &span_downsample_c };
+
+// select the fastest kernels this CPU supports
+void olc_SpanKernels_Init()
+{
+    olc_SpanKernels c = { "C", &span_fill_c, &span_copy, &span_copy_masked_c, &span_blend_c, &span_fill_blend_c, &span_copy_tinted_c, &span_blend_premul_c, &span_bilerp_c, &span_downsample_c };
+    olc_Span = c;
+
+#ifdef OLC_SIMD_X86
+    if(SDL_HasSSE2())
+    {
+        olc_SpanKernels sse2 = { "SSE2", &span_fill_sse2, &span_copy, &span_copy_masked_sse2, &span_blend_sse2, &span_fill_blend_sse2, &span_copy_tinted_sse2, &span_blend_premul_sse2, &span_bilerp_sse2, &span_downsample_sse2 };
+        olc_Span = sse2;
+    }
+
+    if(SDL_HasAVX2())
+    {
+        olc_SpanKernels avx2 = { "AVX2", &span_fill_avx2, &span_copy, &span_copy_masked_avx2, &span_blend_avx2, &span_fill_blend_avx2, &span_copy_tinted_avx2, &span_blend_premul_avx2, &span_bilerp_avx2, &span_downsample_avx2 };
+        olc_Span = avx2;
+    }
+#endif
+}
+
+// O------------------------------------------------------------------------------O
+// | olc_vX2d - A generic 2D vector type                                          |
+// O------------------------------------------------------------------------------O
+
+olc_vi2d olc_VI2D(int x, int y) { olc_vi2d ret; ret.x = x; ret.y = y; return ret; }
+olc_vf2d olc_VF2D(float x, float y) { olc_vf2d ret; ret.x = x; ret.y = y; return ret; }
+olc_vd2d olc_VD2D(double x, double y) { olc_vd2d ret; ret.x = x; ret.y = y; return ret; }
+
+
+// O------------------------------------------------------------------------------O
+// | olc_Transform2D - An affine transform of the 2D plane                        |
+// O------------------------------------------------------------------------------O
+
+olc_Transform2D olc_Transform2D_Identity()
+{
+    olc_Transform2D t = {{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } }};
+    return t;
+}
+
+// Locally used function, a followed by b
+olc_Transform2D Transform2D_Then(olc_Transform2D a, olc_Transform2D b)
+{
+    olc_Transform2D r;
+    for(int i = 0; i < 2; i++)
+    {
+        r.m[i][0] = b.m[i][0] * a.m[0][0] + b.m[i][1] * a.m[1][0];
+        r.m[i][1] = b.m[i][0] * a.m[0][1] + b.m[i][1] * a.m[1][1];
+        r.m[i][2] = b.m[i][0] * a.m[0][2] + b.m[i][1] * a.m[1][2] + b.m[i][2];
+    }
+    return r;
+}
+
+olc_Transform2D olc_Transform2D_Translate(olc_Transform2D t, float ox, float oy)
+{
+    olc_Transform2D op = {{ { 1.0f, 0.0f, ox }, { 0.0f, 1.0f, oy } }};
+    return Transform2D_Then(t, op);
+}
+
+olc_Transform2D olc_Transform2D_Rotate(olc_Transform2D t, float fTheta)
+{
+    float c = cosf(fTheta), s = sinf(fTheta);
+    olc_Transform2D op = {{ { c, -s, 0.0f }, { s, c, 0.0f } }};
+    return Transform2D_Then(t, op);
+}
+
+olc_Transform2D olc_Transform2D_Scale(olc_Transform2D t, float sx, float sy)
+{
+    olc_Transform2D op = {{ { sx, 0.0f, 0.0f }, { 0.0f, sy, 0.0f } }};
+    return Transform2D_Then(t, op);
+}
+
+olc_Transform2D olc_Transform2D_Shear(olc_Transform2D t, float sx, float sy)
+{
+    olc_Transform2D op = {{ { 1.0f, sx, 0.0f }, { sy, 1.0f, 0.0f } }};
+    return Transform2D_Then(t, op);
+}
+
+bool olc_Transform2D_Invert(olc_Transform2D t, olc_Transform2D* inverse)
+{
+    float det = t.m[0][0] * t.m[1][1] - t.m[0][1] * t.m[1][0];
+    if(det == 0.0f || !isfinite(det)) return false;
+
+    float id = 1.0f / det;
+    inverse->m[0][0] =  t.m[1][1] * id;
+    inverse->m[0][1] = -t.m[0][1] * id;
+    inverse->m[1][0] = -t.m[1][0] * id;
+    inverse->m[1][1] =  t.m[0][0] * id;
+    inverse->m[0][2] = -(inverse->m[0][0] * t.m[0][2] + inverse->m[0][1] * t.m[1][2]);
+    inverse->m[1][2] = -(inverse->m[1][0] * t.m[0][2] + inverse->m[1][1] * t.m[1][2]);
+    return true;
+}
+
+olc_vf2d olc_Transform2D_Forward(olc_Transform2D t, olc_vf2d p)
+{
+    return olc_VF2D(t.m[0][0] * p.x + t.m[0][1] * p.y + t.m[0][2], t.m[1][0] * p.x + t.m[1][1] * p.y + t.m[1][2]);
+}
+
+
+// O------------------------------------------------------------------------------O
+// | olc::Sprite - An image represented by a 2D array of olc::Pixel               |
+// O------------------------------------------------------------------------------O
+
+olc_Sprite* olc_Sprite_CreateUninitialised(int32_t w, int32_t h)
+{
+    olc_Sprite* sprite;
+
+    sprite = (olc_Sprite*)olc_Malloc(sizeof(olc_Sprite), olc_ALLOC_GENERAL);
+    if(sprite == NULL)
+    {
+        fprintf(stderr, "Failed to allcoate ram for sprite.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    sprite->width = w;
+    sprite->height = h;
+    sprite->stride = (w + olc_nSpriteRowAlign - 1) / olc_nSpriteRowAlign * olc_nSpriteRowAlign;
+    sprite->pixels = (uint32_t*)olc_AlignedAlloc(sizeof(uint32_t) * sprite->stride * (h > 0 ? h : 1), olc_nSpriteAlignment, olc_ALLOC_SPRITE_PIXELS);
+    sprite->modeSample = olc_SPRITEMODE_NORMAL; // Good Catch! Thanks Tarry
+    sprite->parent = NULL;
+    sprite->bPremultiplied = false;
+    sprite->spans = NULL;
+    sprite->mip = NULL;
+    sprite->depth = NULL;
+    sprite->nDepthBits = 0;
+
+    if(sprite->pixels == NULL)
+    {
+        fprintf(stderr, "Failed to allocate ram for sprite pixel data.\n"); // Gusgo Spellcheck PRO+, coming to Google soon!
+        exit(EXIT_FAILURE);
+    }
+
+    return sprite;
+}
+
+olc_Sprite* olc_Sprite_Create(int32_t w, int32_t h)
+{
+    olc_Sprite* sprite = olc_Sprite_CreateUninitialised(w, h);
+    memset(sprite->pixels, 0, sizeof(uint32_t) * sprite->stride * h);
+    return sprite;
+}
+
+olc_Sprite* olc_Sprite_CreateView(olc_Sprite* parent, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    if(parent == NULL) return NULL;
+
+    // clip the region to the parent
+    int32_t x2 = x + w;
+    int32_t y2 = y + h;
+
+    if (x < 0) x = 0;
+    if (x > parent->width) x = parent->width;
+    if (y < 0) y = 0;
+    if (y > parent->height) y = parent->height;
+
+    if (x2 < x) x2 = x;
+    if (x2 > parent->width) x2 = parent->width;
+    if (y2 < y) y2 = y;
+    if (y2 > parent->height) y2 = parent->height;
+
+    olc_Sprite* sprite = (olc_Sprite*)olc_Malloc(sizeof(olc_Sprite), olc_ALLOC_GENERAL);
+    if(sprite == NULL)
+    {
+        fprintf(stderr, "Failed to allcoate ram for sprite view.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    sprite->width = x2 - x;
+    sprite->height = y2 - y;
+    sprite->stride = parent->stride;
+    sprite->pixels = parent->pixels + y * parent->stride + x;
+    sprite->modeSample = parent->modeSample;
+    sprite->parent = parent;
+    sprite->bPremultiplied = parent->bPremultiplied;
+    sprite->spans = NULL;
+    sprite->mip = NULL;
+    sprite->depth = NULL;
+    sprite->nDepthBits = 0;
+
+    return sprite;
+}
+
+olc_Sprite* olc_Sprite_Load(const char *sImageFile)
+{
+    return olc_Sprite_LoadFromFile(sImageFile);
+}
+
+void olc_Sprite_Destroy(olc_Sprite* sprite)
+{
+    olc_Free(sprite->spans);
+    if(sprite->mip != NULL)
+        olc_Sprite_Destroy(sprite->mip);
+
+    // views only borrow their parent's pixels
+    if(sprite->parent == NULL)
+    {
+        olc_AlignedFree(sprite->pixels);
+        olc_Free(sprite->depth);
+    }
+    sprite->pixels = NULL;
+    
+    olc_Free(sprite);
+    sprite = NULL;
+}
+
+olc_Sprite* olc_Sprite_LoadFromPGESprFile(const char *sImageFile)
+{
+    int32_t width;
+    int32_t height;
+    
+    FILE* fp = fopen(sImageFile, "rb");
+    if(fp)
+    {
+        fread(&width, sizeof(int32_t), 1, fp);
+        fread(&height, sizeof(int32_t), 1, fp);
+
+        // every pixel is read from the file, no need to clear them first
+        olc_Sprite* sprite = olc_Sprite_CreateUninitialised(width, height);
 
         for(int y = 0; y < height; y++)
         {
+            uint32_t* row = sprite->pixels + y * sprite->stride;
+            if(fread(row, sizeof(uint32_t), width, fp) != (size_t)width)
+                memset(row, 0, sizeof(uint32_t) * width);
+
             for(int x = 0; x < width; x++)
             {
-                olc_Pixel p = olc_PixelRAW(pixels[y * width + x]);
+                olc_Pixel p = olc_PixelRAW(row[x]);
                 
                 if(p.a == 0)
-                    p = olc_BLANK;
-
-                olc_Sprite_SetPixel(sprite, x, y, p);
+                    row[x] = olc_BLANK.n;
+                else if(PGE.bPremultipliedAlpha)
+                    row[x] = premultiply_px(row[x]);
             }
         }
         
         fclose(fp);
-        free(pixels);
+        sprite->bPremultiplied = PGE.bPremultipliedAlpha;
 
         return sprite;
     }
@@ -284,102 +1461,382 @@ olc_Sprite* olc_Sprite_LoadFromPGESprFile(const char *sImageFile)
     fprintf(stderr, "Error loading PGESprite: %s\n", sImageFile);
     exit(EXIT_FAILURE);
 
-    return NULL;
+    return NULL;
+}
+
+int32_t olc_Sprite_SaveToPGESprFile(olc_Sprite* sprite, const char *sImageFile)
+{
+    if(sprite == NULL)
+        return olc_RCODE_FAIL;
+
+    uint32_t* pixels = olc_Sprite_GetData(sprite);
+
+    if(pixels == NULL) return olc_RCODE_FAIL;
+
+    FILE* fp = fopen(sImageFile, "wb");
+    if(fp)
+    {
+        fwrite(&sprite->width, sizeof(uint32_t), 1, fp);
+        fwrite(&sprite->height, sizeof(uint32_t), 1, fp);
+
+        // the file format has no row padding
+        for(int y = 0; y < sprite->height; y++)
+            fwrite(pixels + y * sprite->stride, sizeof(uint32_t), sprite->width, fp);
+        
+        fclose(fp);    
+        return olc_RCODE_OK;
+    }
+
+    return olc_RCODE_FAIL;
+}
+
+void olc_Sprite_SetSampleMode(olc_Sprite* sprite, uint32_t mode)
+{
+    sprite->modeSample = mode;
+}
+
+olc_Pixel olc_Sprite_GetPixel(olc_Sprite* sprite, int32_t x, int32_t y)
+{
+    if(x >= 0 && y >= 0 && x < sprite->width && y < sprite->height)
+    {
+        return olc_PixelRAW(sprite->pixels[y * sprite->stride + x]);
+    }
+
+    return olc_PixelDefault();
+}
+
+bool olc_Sprite_SetPixel(olc_Sprite* sprite, int32_t x, int32_t y, olc_Pixel p)
+{
+    if(x >= 0 && y >= 0 && x < sprite->width && y < sprite->height)
+    {
+        sprite->pixels[y * sprite->stride + x] = p.n;
+        olc_Sprite_Invalidate(sprite);
+        return true;
+    }
+    
+    return false;
+}
+
+olc_Pixel olc_Sprite_Sample(olc_Sprite* sprite, float x, float y)
+{
+    olc_Sampler s = olc_Sampler_Create(sprite, (sprite->modeSample == olc_SPRITEMODE_PERIODIC) ? olc_SPRITEWRAP_REPEAT : olc_SPRITEWRAP_CLAMP, olc_SPRITEFILTER_NEAREST);
+    return olc_Sampler_Sample(&s, olc_VF2D(x, y));
+}
+
+olc_Pixel olc_Sprite_SampleBL(olc_Sprite* sprite, float u, float v)
+{
+    olc_Sampler s = olc_Sampler_Create(sprite, (sprite->modeSample == olc_SPRITEMODE_PERIODIC) ? olc_SPRITEWRAP_REPEAT : olc_SPRITEWRAP_CLAMP, olc_SPRITEFILTER_BILINEAR);
+    return olc_Sampler_Sample(&s, olc_VF2D(u, v));
+}
+
+uint32_t* olc_Sprite_GetData(olc_Sprite* sprite)
+{
+    return sprite->pixels;
+}
+
+int32_t olc_Sprite_GetStride(olc_Sprite* sprite)
+{
+    return sprite->stride;
+}
+
+olc_Sprite* olc_Sprite_GetRoot(olc_Sprite* sprite)
+{
+    while(sprite->parent != NULL) sprite = sprite->parent;
+    return sprite;
+}
+
+olc_SpriteSpans* olc_Sprite_GetSpans(olc_Sprite* sprite)
+{
+    // views share their pixels with a parent that can change under them
+    if(sprite == NULL || sprite->parent != NULL) return NULL;
+    if(sprite->spans != NULL) return sprite->spans;
+
+    // count the runs first, so the index fits in one block
+    size_t nRuns = 0;
+    for(int32_t y = 0; y < sprite->height; y++)
+    {
+        const uint32_t* row = sprite->pixels + y * sprite->stride;
+        bool bOpaque = false;
+        for(int32_t x = 0; x < sprite->width; x++)
+        {
+            bool b = (row[x] >> 24) == 0xFF;
+            if(b && !bOpaque) nRuns++;
+            bOpaque = b;
+        }
+    }
+
+    size_t nRowBytes = sizeof(int32_t) * (sprite->height + 1);
+    nRowBytes = (nRowBytes + sizeof(olc_SpriteRun) - 1) / sizeof(olc_SpriteRun) * sizeof(olc_SpriteRun);
+    uint8_t* block = (uint8_t*)olc_Malloc(sizeof(olc_SpriteSpans) + nRowBytes + sizeof(olc_SpriteRun) * nRuns, olc_ALLOC_SPRITE_PIXELS);
+    if(block == NULL)
+    {
+        fprintf(stderr, "Failed to allocate ram for sprite spans.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    olc_SpriteSpans* spans = (olc_SpriteSpans*)block;
+    spans->rows = (int32_t*)(block + sizeof(olc_SpriteSpans));
+    spans->runs = (olc_SpriteRun*)(block + sizeof(olc_SpriteSpans) + nRowBytes);
+
+    int32_t r = 0;
+    for(int32_t y = 0; y < sprite->height; y++)
+    {
+        const uint32_t* row = sprite->pixels + y * sprite->stride;
+        spans->rows[y] = r;
+        for(int32_t x = 0; x < sprite->width; x++)
+        {
+            if((row[x] >> 24) != 0xFF) continue;
+            spans->runs[r].start = x;
+            while(x < sprite->width && (row[x] >> 24) == 0xFF) x++;
+            spans->runs[r].length = x - spans->runs[r].start;
+            r++;
+        }
+    }
+    spans->rows[sprite->height] = r;
+
+    sprite->spans = spans;
+    return spans;
+}
+
+// Locally used function, the rounded mean of the nx by ny block of sprite's
+// pixels at (x0,y0), channel by channel
+uint32_t Sprite_BlockMean(olc_Sprite* sprite, int32_t x0, int32_t nx, int32_t y0, int32_t ny)
+{
+    uint32_t sum[4] = { 0, 0, 0, 0 }, n = (uint32_t)(nx * ny), r = 0;
+
+    for(int32_t y = y0; y < y0 + ny; y++)
+        for(int32_t x = x0; x < x0 + nx; x++)
+            for(int32_t c = 0; c < 4; c++)
+                sum[c] += (sprite->pixels[y * sprite->stride + x] >> (8 * c)) & 0xFF;
+
+    for(int32_t c = 0; c < 4; c++)
+        r |= ((sum[c] + n / 2) / n) << (8 * c);
+
+    return r;
+}
+
+// Locally used function, the next mip level of sprite: half the size, each
+// pixel the mean of a 2x2 block. An odd last row or column is folded into the
+// block beside it, making that block three wide or high, and a side of one
+// pixel stays at one
+olc_Sprite* Sprite_Halve(olc_Sprite* sprite)
+{
+    int32_t w = (sprite->width > 1) ? sprite->width / 2 : 1;
+    int32_t h = (sprite->height > 1) ? sprite->height / 2 : 1;
+    olc_Sprite* mip = olc_Sprite_CreateUninitialised(w, h);
+    mip->modeSample = sprite->modeSample;
+    mip->bPremultiplied = sprite->bPremultiplied;
+
+    // the columns that are plain 2x2 blocks, the rest are folded or one pixel wide
+    int32_t nBlocks = (sprite->width > 1) ? w - (sprite->width & 1) : 0;
+
+    for(int32_t y = 0; y < h; y++)
+    {
+        int32_t ny = (sprite->height == 1) ? 1 : (y == h - 1 && (sprite->height & 1)) ? 3 : 2;
+        uint32_t* dst = mip->pixels + y * mip->stride;
+        int32_t x = 0;
+
+        if(ny == 2)
+        {
+            const uint32_t* r0 = sprite->pixels + (2 * y) * sprite->stride;
+            olc_Span.downsample(dst, r0, r0 + sprite->stride, nBlocks);
+            x = nBlocks;
+        }
+
+        for(; x < w; x++)
+        {
+            int32_t nx = (sprite->width == 1) ? 1 : (x == w - 1 && (sprite->width & 1)) ? 3 : 2;
+            dst[x] = Sprite_BlockMean(sprite, 2 * x, nx, 2 * y, ny);
+        }
+    }
+
+    return mip;
+}
+
+olc_Sprite* olc_Sprite_GetMip(olc_Sprite* sprite, uint32_t level)
+{
+    // a level built from the draw target would go stale with the next draw
+    if(PGE.pDrawTarget != NULL && olc_Sprite_GetRoot(sprite) == olc_Sprite_GetRoot(PGE.pDrawTarget)) return sprite;
+
+    // views share their pixels with a parent that can change under them
+    for(; level > 0 && sprite->parent == NULL && (sprite->width > 1 || sprite->height > 1); level--)
+    {
+        if(sprite->mip == NULL) sprite->mip = Sprite_Halve(sprite);
+        sprite = sprite->mip;
+    }
+    return sprite;
+}
+
+void olc_Sprite_Invalidate(olc_Sprite* sprite)
+{
+    // a view writes into its parents' pixels too
+    for(; sprite != NULL; sprite = sprite->parent)
+    {
+        if(sprite->spans != NULL)
+        {
+            olc_Free(sprite->spans);
+            sprite->spans = NULL;
+        }
+
+        if(sprite->mip != NULL)
+        {
+            olc_Sprite_Destroy(sprite->mip);
+            sprite->mip = NULL;
+        }
+    }
+}
+
+void olc_Sprite_SetDepth(olc_Sprite* sprite, uint32_t bits)
+{
+    // the plane belongs to the sprite that owns the pixels, and lines up with them
+    sprite = olc_Sprite_GetRoot(sprite);
+    olc_Free(sprite->depth);
+    sprite->depth = NULL;
+    sprite->nDepthBits = 0;
+    if(bits == 0) return;
+
+    sprite->nDepthBits = (bits <= 16) ? 16 : 32;
+    size_t size = (size_t)sprite->stride * (sprite->height > 0 ? sprite->height : 1) * (sprite->nDepthBits / 8);
+    sprite->depth = olc_Malloc(size, olc_ALLOC_SPRITE_PIXELS);
+    if(sprite->depth == NULL)
+    {
+        fprintf(stderr, "Failed to allocate sprite depth plane.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // every bit set is as far away as a depth can be, in either size
+    memset(sprite->depth, 0xFF, size);
 }
 
-int32_t olc_Sprite_SaveToPGESprFile(olc_Sprite* sprite, const char *sImageFile)
+void olc_Sprite_Premultiply(olc_Sprite* sprite)
 {
-    if(sprite == NULL)
-        return olc_RCODE_FAIL;
+    if(sprite == NULL || sprite->bPremultiplied) return;
 
-    uint32_t* pixels = olc_Sprite_GetData(sprite);
+    for(int32_t y = 0; y < sprite->height; y++)
+    {
+        uint32_t* row = sprite->pixels + y * sprite->stride;
+        for(int32_t x = 0; x < sprite->width; x++)
+            row[x] = premultiply_px(row[x]);
+    }
 
-    if(pixels == NULL) return olc_RCODE_FAIL;
+    sprite->bPremultiplied = true;
+    olc_Sprite_Invalidate(sprite);
+}
 
-    FILE* fp = fopen(sImageFile, "w");
-    if(fp)
+void olc_Sprite_Unpremultiply(olc_Sprite* sprite)
+{
+    if(sprite == NULL || !sprite->bPremultiplied) return;
+
+    for(int32_t y = 0; y < sprite->height; y++)
     {
-        fwrite(&sprite->width, sizeof(uint32_t), 1, fp);
-        fwrite(&sprite->height, sizeof(uint32_t), 1, fp);
-        fwrite(pixels, sizeof(uint32_t), sprite->width * sprite->height, fp);
-        
-        fclose(fp);    
-        return olc_RCODE_OK;
+        uint32_t* row = sprite->pixels + y * sprite->stride;
+        for(int32_t x = 0; x < sprite->width; x++)
+            row[x] = unpremultiply_px(row[x]);
     }
-    
-    fclose(fp);
 
-    return olc_RCODE_FAIL;
+    sprite->bPremultiplied = false;
+    olc_Sprite_Invalidate(sprite);
 }
 
-void olc_Sprite_SetSampleMode(olc_Sprite* sprite, uint32_t mode)
+
+// O------------------------------------------------------------------------------O
+// | olc_Sampler - Reads runs of filtered texels out of a sprite                  |
+// O------------------------------------------------------------------------------O
+
+olc_Sampler olc_Sampler_Create(olc_Sprite* sprite, uint32_t wrap, uint32_t filter)
 {
-    sprite->modeSample = mode;
+    olc_Sampler s;
+    s.sprite = sprite;
+    s.wrap = wrap;
+    s.filter = filter;
+    return s;
 }
 
-olc_Pixel olc_Sprite_GetPixel(olc_Sprite* sprite, int32_t x, int32_t y)
+// Locally used function, brings texel index x back into [0, n)
+static inline int32_t wrap_texel(int64_t x, int32_t n, uint32_t wrap)
 {
-    if(x >= 0 && y >= 0 && x < sprite->width && y < sprite->height)
+    if(x >= 0 && x < n) return (int32_t)x;
+
+    switch(wrap)
     {
-        return olc_PixelRAW(sprite->pixels[y * sprite->width + x]);
+        case olc_SPRITEWRAP_REPEAT:
+            x %= n;
+            return (int32_t)((x < 0) ? x + n : x);
+
+        case olc_SPRITEWRAP_MIRROR:
+            x %= 2 * (int64_t)n;
+            if(x < 0) x += 2 * (int64_t)n;
+            return (int32_t)((x < n) ? x : 2 * (int64_t)n - 1 - x);
+
+        default:
+            return (x < 0) ? 0 : n - 1;
     }
+}
 
-    return olc_PixelDefault();
+olc_Pixel olc_Sampler_Sample(const olc_Sampler* sampler, olc_vf2d uv)
+{
+    olc_Pixel p;
+    olc_Sampler_SampleSpan(sampler, uv, olc_VF2D(0.0f, 0.0f), &p, 1);
+    return p;
 }
 
-bool olc_Sprite_SetPixel(olc_Sprite* sprite, int32_t x, int32_t y, olc_Pixel p)
+void olc_Sampler_SampleSpan(const olc_Sampler* sampler, olc_vf2d uv, olc_vf2d duv, olc_Pixel* out, int32_t count)
 {
-    if(x >= 0 && y >= 0 && x < sprite->width && y < sprite->height)
+    olc_Sprite* sprite = sampler->sprite;
+    if(sprite == NULL || sprite->width <= 0 || sprite->height <= 0)
     {
-        sprite->pixels[y * sprite->width + x] = p.n;
-        return true;
+        for(int32_t i = 0; i < count; i++) out[i] = olc_PixelDefault();
+        return;
     }
-    
-    return false;
-}
 
-olc_Pixel olc_Sprite_Sample(olc_Sprite* sprite, float x, float y)
-{
-    int32_t a, b;
-    
-    a = (int32_t)((x * (float)sprite->width));
-    b = sprite->width - 1;
-    int32_t sx = (a < b) ? a : b;
-    
-    a = (int32_t)((y * (float)sprite->height));
-    b = sprite->height - 1;
-    int32_t sy = (a < b) ? a : b;
+    // when shrinking, read the mip level whose texels are about a step apart
+    if(sampler->filter & olc_SPRITEFILTER_MIPMAP)
+    {
+        double fStep = fmax(fabs((double)duv.x * sprite->width), fabs((double)duv.y * sprite->height));
+        uint32_t level = 0;
+        for(; fStep >= 2.0 && level < 31; fStep *= 0.5) level++;
+        sprite = olc_Sprite_GetMip(sprite, level);
+    }
 
-    return olc_Sprite_GetPixel(sprite, sx, sy);
-}
+    // texel coordinates in 16.16 fixed-point, stepped rather than recomputed
+    int32_t w = sprite->width, h = sprite->height;
+    int64_t tu = llround((double)uv.x * w * 65536.0), tv = llround((double)uv.y * h * 65536.0);
+    int64_t dtu = llround((double)duv.x * w * 65536.0), dtv = llround((double)duv.y * h * 65536.0);
+    uint32_t wrap = sampler->wrap;
 
-olc_Pixel olc_Sprite_SampleBL(olc_Sprite* sprite, float u, float v)
-{
-    u = u * sprite->width - 0.5f;
-    v = v * sprite->height - 0.5f;
+    if(!(sampler->filter & olc_SPRITEFILTER_BILINEAR))
+    {
+        for(int32_t i = 0; i < count; i++, tu += dtu, tv += dtv)
+        {
+            int32_t x = wrap_texel(tu >> 16, w, wrap), y = wrap_texel(tv >> 16, h, wrap);
+            out[i].n = sprite->pixels[y * sprite->stride + x];
+        }
+        return;
+    }
 
-    int x = (int)floor(u); // cast to int rounds toward zero, not downward
-    int y = (int)floor(v); // Thanks @joshinils
-    float u_ratio = u - x;
-    float v_ratio = v - y;
-    float u_opposite = 1 - u_ratio;
-    float v_opposite = 1 - v_ratio;
+    // gather the four taps and weights of a chunk of samples, then let the
+    // bilerp kernel blend the lot
+    uint32_t taps[4 * 64], weights[64];
+    for(int32_t n = 0; n < count; n += 64)
+    {
+        int32_t chunk = (count - n < 64) ? count - n : 64;
 
-    olc_Pixel p1 = olc_Sprite_GetPixel(sprite, olc_MAX(x, 0), olc_MAX(y, 0));
-    olc_Pixel p2 = olc_Sprite_GetPixel(sprite, olc_MIN(x + 1, (int)sprite->width - 1), olc_MAX(y, 0));
-    olc_Pixel p3 = olc_Sprite_GetPixel(sprite, olc_MAX(x, 0), olc_MIN(y + 1, (int)sprite->height - 1));
-    olc_Pixel p4 = olc_Sprite_GetPixel(sprite, olc_MIN(x + 1, (int)sprite->width - 1), olc_MIN(y + 1, (int)sprite->height - 1));
+        for(int32_t i = 0; i < chunk; i++, tu += dtu, tv += dtv)
+        {
+            int64_t bu = tu - 32768, bv = tv - 32768;
+            int32_t x0 = wrap_texel(bu >> 16, w, wrap), x1 = wrap_texel((bu >> 16) + 1, w, wrap);
+            const uint32_t* r0 = sprite->pixels + wrap_texel(bv >> 16, h, wrap) * sprite->stride;
+            const uint32_t* r1 = sprite->pixels + wrap_texel((bv >> 16) + 1, h, wrap) * sprite->stride;
+
+            taps[4 * i + 0] = r0[x0]; taps[4 * i + 1] = r0[x1];
+            taps[4 * i + 2] = r1[x0]; taps[4 * i + 3] = r1[x1];
+            weights[i] = (uint32_t)((bu >> 8) & 0xFF) | ((uint32_t)((bv >> 8) & 0xFF) << 16);
+        }
 
-    return olc_PixelRGB(
-    	(uint8_t)((p1.r * u_opposite + p2.r * u_ratio) * v_opposite + (p3.r * u_opposite + p4.r * u_ratio) * v_ratio),
-    	(uint8_t)((p1.g * u_opposite + p2.g * u_ratio) * v_opposite + (p3.g * u_opposite + p4.g * u_ratio) * v_ratio),
-    	(uint8_t)((p1.b * u_opposite + p2.b * u_ratio) * v_opposite + (p3.b * u_opposite + p4.b * u_ratio) * v_ratio));
+        olc_Span.bilerp(&out[n].n, taps, weights, chunk);
+    }
 }
 
-uint32_t* olc_Sprite_GetData(olc_Sprite* sprite)
-{
-    return sprite->pixels;
-}
 
 // O------------------------------------------------------------------------------O
 // | olc::Decal - A GPU resident storage of an olc::Sprite                        |
@@ -388,7 +1845,7 @@ olc_Decal* olc_Decal_Create(olc_Sprite* sprite)
 {
     if(sprite == NULL) return NULL;
 
-    olc_Decal* decal = (olc_Decal*)malloc(sizeof(olc_Decal));
+    olc_Decal* decal = (olc_Decal*)olc_Malloc(sizeof(olc_Decal), olc_ALLOC_GENERAL);
     if(decal == NULL)
     {
         fprintf(stderr, "Error creating decal.\n");
@@ -399,6 +1856,7 @@ olc_Decal* olc_Decal_Create(olc_Sprite* sprite)
     decal->sprite = sprite;
     decal->vUVScale = olc_VF2D( 1.0f, 1.0f );
     decal->id = olc_Renderer_CreateTexture(decal->sprite->width, decal->sprite->height);
+    olc_Renderer_SetTexturePremultiplied(decal->id, sprite->bPremultiplied);
     olc_Decal_Update(decal);
     
     return decal;
@@ -410,7 +1868,7 @@ void olc_Decal_Destroy(olc_Decal* decal)
     {
         olc_Renderer_DeleteTexture(decal->id);
         decal->id = -1;
-        free(decal);
+        olc_Free(decal);
     }
 }
 
@@ -427,7 +1885,7 @@ void olc_Decal_Update(olc_Decal* decal)
 // O------------------------------------------------------------------------------O
 olc_Renderable* olc_Renderable_Create(uint32_t width, uint32_t height)
 {
-    olc_Renderable* renderable = (olc_Renderable*)malloc(sizeof(olc_Renderable));
+    olc_Renderable* renderable = (olc_Renderable*)olc_Malloc(sizeof(olc_Renderable), olc_ALLOC_GENERAL);
     if(renderable == NULL)
     {
         fprintf(stderr,"Error creating olc_Renderable\n");
@@ -442,7 +1900,7 @@ olc_Renderable* olc_Renderable_Create(uint32_t width, uint32_t height)
 
 olc_Renderable* olc_Renderable_Load(const char* sFile)
 {
-    olc_Renderable* renderable = (olc_Renderable*)malloc(sizeof(olc_Renderable));
+    olc_Renderable* renderable = (olc_Renderable*)olc_Malloc(sizeof(olc_Renderable), olc_ALLOC_GENERAL);
     if(renderable == NULL)
     {
         fprintf(stderr,"Error creating olc_Renderable\n");
@@ -475,13 +1933,20 @@ olc_Decal* olc_Renderable_GetDecal(olc_Renderable* renderable)
 
 olc_DecalInstance* olc_DecalInstance_Create()
 {
-    olc_DecalInstance* di = (olc_DecalInstance*)malloc(sizeof(olc_DecalInstance));
+    olc_DecalInstance* di = (olc_DecalInstance*)olc_Malloc(sizeof(olc_DecalInstance), olc_ALLOC_DECAL_INSTANCES);
     if(di == NULL)
     {
         fprintf(stderr, "Error create Decal Instance.\n");
         exit(EXIT_FAILURE);
     }
 
+    olc_DecalInstance_Init(di);
+
+    return di;
+}
+
+void olc_DecalInstance_Init(olc_DecalInstance* di)
+{
     di->decal = NULL;
 
     di->pos[0] = olc_VF2D(0.0f, 0.0f); di->pos[1] = olc_VF2D(0.0f, 0.0f);
@@ -492,6 +1957,38 @@ olc_DecalInstance* olc_DecalInstance_Create()
 
     di->w[0] = di->w[1] = di->w[2] = di->w[3] = 1.0f;
     di->tint[0] = di->tint[1] = di->tint[2] = di->tint[3] = olc_WHITE;
+}
+
+// init arena struct
+void olc_DecalInstanceArena_Init(olc_DecalInstanceArena* arena)
+{
+    olc_vector_olc_DecalInstance_init(&arena->instances);
+    arena->peak = 0;
+}
+
+// free the memory used by the arena and reset capacity, size and peak to 0
+void olc_DecalInstanceArena_Free(olc_DecalInstanceArena* arena)
+{
+    olc_vector_olc_DecalInstance_free(&arena->instances);
+    arena->peak = 0;
+}
+
+// forget every instance in the arena, keeping its memory for the next frame
+void olc_DecalInstanceArena_Reset(olc_DecalInstanceArena* arena)
+{ olc_vector_olc_DecalInstance_clear(&arena->instances); }
+
+// append a default initialised instance, pointer is valid until the next push
+olc_DecalInstance* olc_DecalInstanceArena_Push(olc_DecalInstanceArena* arena)
+{
+    // start with a sensible block, so light scenes never regrow the arena
+    if(arena->instances.capacity == 0)
+        olc_vector_olc_DecalInstance_reserve(&arena->instances, 64);
+
+    olc_DecalInstance* di = olc_vector_olc_DecalInstance_emplace(&arena->instances);
+    if(arena->instances.size > arena->peak)
+        arena->peak = arena->instances.size;
+
+    olc_DecalInstance_Init(di);
 
     return di;
 }
@@ -500,6 +1997,11 @@ void olc_DefaultState()
 {
     PGE.nPixelMode = olc_PIXELMODE_NORMAL;
     PGE.fBlendFactor = 1.0f;
+    PGE.nBlendFactor = 256;
+    PGE.bPremultipliedAlpha = false;
+    PGE.bDepthTest = false;
+    PGE.bDepthWrite = false;
+    PGE.nDrawDepth = 0;
     PGE.bHasInputFocus = true;
     PGE.bHasMouseFocus = true;
     PGE.fFrameTimer = 0.0f;
@@ -539,6 +2041,7 @@ int32_t Construct(int32_t screen_w, int32_t screen_h, int32_t pixel_w, int32_t p
         return olc_RCODE_FAIL;
 
     olc_PixelColourInit();
+    olc_SpanKernels_Init();
     olc_DefaultState();
 
     return olc_RCODE_OK;
@@ -682,7 +2185,7 @@ void SetScreenSize(int w, int h)
 
     for(int i = 0; i < PGE.vLayers.size; i++)
     {
-        olc_LayerDesc* ld = (olc_LayerDesc*)vector_get(&PGE.vLayers, i);
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, i);
         olc_Sprite_Destroy(ld->pDrawTarget);
         ld->pDrawTarget = olc_Sprite_Create(PGE.vScreenSize.x, PGE.vScreenSize.y);
         ld->bUpdate = true;
@@ -702,7 +2205,7 @@ void SetDrawTarget(olc_Sprite *target)
 {
     if(target == NULL)
     {
-        olc_LayerDesc* ld = (olc_LayerDesc*)vector_get(&PGE.vLayers, 0);
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, 0);
         PGE.pDrawTarget = ld->pDrawTarget;
         PGE.nTargetLayer = 0;
     }
@@ -710,6 +2213,9 @@ void SetDrawTarget(olc_Sprite *target)
     {
         PGE.pDrawTarget = target;
     }
+
+    // whatever is drawn next changes the target's pixels
+    olc_Sprite_Invalidate(PGE.pDrawTarget);
 }
 
 // Gets the current Frames Per Second
@@ -735,114 +2241,356 @@ bool IsMouseCursorVisible()
 // Draws a single Pixel
 bool Draw(int32_t x, int32_t y, olc_Pixel p)
 {
-    if(!PGE.pDrawTarget) return false;
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(!target) return false;
+    if(x < 0 || y < 0 || x >= target->width || y >= target->height) return false;
+
+    if(depthon())
+    {
+        int32_t i = 0, n;
+        if(!depthrun(NULL, p.n, x, y, 1, &i, &n)) return false;
+    }
+
+    // written in place, SetDrawTarget has already let go of anything cached from
+    // the target's pixels
+    uint32_t* d = target->pixels + y * target->stride + x;
 
     if(PGE.nPixelMode == olc_PIXELMODE_NORMAL)
     {
-        return olc_Sprite_SetPixel(PGE.pDrawTarget, x, y, p);
+        *d = target->bPremultiplied ? premultiply_px(p.n) : p.n;
+        return true;
     }
 
     if(PGE.nPixelMode == olc_PIXELMODE_MASK)
     {
         if(p.a == 255)
-            return olc_Sprite_SetPixel(PGE.pDrawTarget, x, y, p);
+        {
+            *d = p.n;
+            return true;
+        }
     }
 
     if(PGE.nPixelMode == olc_PIXELMODE_ALPHA)
     {
-        olc_Pixel d = olc_Sprite_GetPixel(PGE.pDrawTarget, x, y);
-        float a = (float)(p.a / 255.0f) * PGE.fBlendFactor;
-        float c = 1.0f - a;
-        float r = a * (float)p.r + c * (float)d.r;
-        float g = a * (float)p.g + c * (float)d.g;
-        float b = a * (float)p.b + c * (float)d.b;
-        return olc_Sprite_SetPixel(PGE.pDrawTarget, x, y, olc_PixelRGB((uint8_t)r, (uint8_t)g, (uint8_t)b));
+        *d = blend_px(p.n, *d, PGE.nBlendFactor);
+        return true;
     }
 
     if(PGE.nPixelMode == olc_PIXELMODE_CUSTOM)
     {
-        return olc_Sprite_SetPixel(PGE.pDrawTarget, x, y, PGE.funcPixelMode(x, y, p, olc_Sprite_GetPixel(PGE.pDrawTarget, x, y)));
+        *d = PGE.funcPixelMode(x, y, p, olc_PixelRAW(*d)).n;
+        return true;
+    }
+
+    if(PGE.nPixelMode == olc_PIXELMODE_CUSTOM_SPAN)
+    {
+        PGE.funcSpanMode(x, y, &p, (olc_Pixel*)d, 1);
+        return true;
     }
 
     return false;
 }
 
+// Locally used, a line's Bresenham walk through the draw target: where it is,
+// both as a pixel pointer d and as (x,y), and how each step moves it
+typedef struct
+{
+    uint32_t* d;
+    int32_t x, y;
+    ptrdiff_t aStep, bStep;
+    int32_t ax, ay, bx, by;
+    int64_t e, eFlat, eMove;
+} LineWalk;
+
+// Locally used function, one step along the major axis, and along the minor
+// one too when the error term says so
+static inline void line_step(LineWalk* w)
+{
+    w->d += w->aStep; w->x += w->ax; w->y += w->ay;
+    if(w->e >= 0) { w->d += w->bStep; w->x += w->bx; w->y += w->by; w->e += w->eMove; }
+    else w->e += w->eFlat;
+}
+
 // Draws a line from (x1,y1) to (x2,y2)
+//
+// The line is stepped as Bresenham would from the end with the lower major
+// coordinate, but the steps k that land inside the draw target are solved for
+// first and the walk starts there, with the error term and pattern already
+// advanced past the skipped prefix. Each pixel mode then gets its own loop
+// writing straight into the target's pixels
 void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, olc_Pixel p, uint32_t pattern)
 {
-    int x, y, dx, dy, dx1, dy1, px, py, xe, ye, i, temp;
-    dx = x2 - x1; dy = y2 - y1;
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || target->width <= 0 || target->height <= 0) return;
+    if(PGE.nPixelMode == olc_PIXELMODE_MASK && p.a != 255) return;
+
+    int64_t dx = (int64_t)x2 - x1, dy = (int64_t)y2 - y1;
+    bool bSteep = llabs(dy) > llabs(dx);
+
+    // the walk in major/minor terms: start (a0,b0), n steps along the major
+    // axis and m along the minor one, in direction s
+    int64_t a0, b0, n, m, s, aSize, bSize;
+    if(!bSteep)
+    {
+        a0 = (dx >= 0) ? x1 : x2; b0 = (dx >= 0) ? y1 : y2;
+        n = llabs(dx); m = llabs(dy); s = ((dx < 0) == (dy < 0)) ? 1 : -1;
+        aSize = target->width; bSize = target->height;
+    }
+    else
+    {
+        a0 = (dy >= 0) ? y1 : y2; b0 = (dy >= 0) ? x1 : x2;
+        n = llabs(dy); m = llabs(dx); s = ((dx < 0) == (dy < 0)) ? 1 : -1;
+        aSize = target->height; bSize = target->width;
+    }
 
-    // straight lines idea by gurkanctn
-    if (dx == 0) // Line is vertical
+    // minor steps that stay inside the target, then the major steps k that take them
+    int64_t mLo = (s > 0) ? -b0 : b0 - (bSize - 1);
+    int64_t mHi = (s > 0) ? bSize - 1 - b0 : b0;
+    if(mLo < 0) mLo = 0;
+    if(mHi > m) mHi = m;
+    if(mLo > mHi) return;
+
+    int64_t k0 = 0, k1 = n, rem;
+    if(m > 0)
     {
-        if (y2 < y1)
+        // after k steps the minor axis has moved floor((2mk + n) / 2n) times, or
+        // ceil((2mk - n) / 2n) when steep, as the classic loops break ties that way.
+        // 2n * mLo and the like can pass 64 bits for lines near the int32 limits
+        if(!bSteep)
+        {
+            k0 = muldivfloor64(n, 2 * mLo, 2 * m - 1 - n, 2 * m, &rem);
+            k1 = muldivfloor64(n, 2 * mHi, 2 * m - 1 + n, 2 * m, &rem) - 1;
+        }
+        else
         {
-            temp = y1;
-            y1 = y2;
-            y2 = temp;
+            k0 = muldivfloor64(n, 2 * mLo, -n, 2 * m, &rem) + 1;
+            k1 = muldivfloor64(n, 2 * mHi, n, 2 * m, &rem);
         }
-        for (y = y1; y <= y2; y++) if (rol(&pattern)) Draw(x1, y, p);
+        if(k0 < 0) k0 = 0;
+        if(k1 > n) k1 = n;
+    }
+    if(k0 < -a0) k0 = -a0;
+    if(k1 > aSize - 1 - a0) k1 = aSize - 1 - a0;
+    if(k0 > k1) return;
+
+    // Bresenham's state at step k0. Moving on the minor axis when e >= 0, with
+    // the steep case's e > 0 folded into e by one, e is what the minor axis
+    // count floor((2mk0 + n - steep) / 2n) leaves over, less 2n - 2m
+    int64_t moves = 0;
+    rem = n - (bSteep ? 1 : 0);
+    if(m > 0) moves = muldivfloor64(2 * m, k0, rem, 2 * n, &rem);
+
+    int32_t x = (int32_t)(!bSteep ? a0 + k0 : b0 + s * moves);
+    int32_t y = (int32_t)(!bSteep ? b0 + s * moves : a0 + k0);
+    int32_t count = (int32_t)(k1 - k0 + 1);
+
+    // pattern bits go one per pixel from the start of the line, skipped ones included
+    uint32_t r = (uint32_t)(k0 & 31);
+    if(r != 0) pattern = (pattern << r) | (pattern >> (32 - r));
+
+    // a solid horizontal run is just a row fill
+    if(m == 0 && !bSteep && pattern == olc_SOLID)
+    {
+        fillrows(x, y, count, 1, p);
         return;
     }
 
-    if (dy == 0) // Line is horizontal
+    LineWalk w;
+    w.d = target->pixels + y * target->stride + x;
+    w.x = x; w.y = y;
+    w.aStep = !bSteep ? 1 : target->stride;
+    w.bStep = !bSteep ? s * target->stride : s;
+    w.ax = !bSteep ? 1 : 0; w.bx = !bSteep ? 0 : (int32_t)s;
+    w.ay = !bSteep ? 0 : 1; w.by = !bSteep ? (int32_t)s : 0;
+    w.e = 2 * m - 2 * n + rem;
+    w.eFlat = 2 * m; w.eMove = 2 * m - 2 * n;
+
+    // the depth test goes pixel by pixel through Draw
+    if(depthon())
     {
-        if (x2 < x1)
+        for(int32_t i = 0; i < count; i++, line_step(&w))
+            if(rol(&pattern)) Draw(w.x, w.y, p);
+    }
+    else switch(PGE.nPixelMode)
+    {
+        case olc_PIXELMODE_NORMAL:
+        case olc_PIXELMODE_MASK:
         {
-            temp = x1;
-            x1 = x2;
-            x2 = temp;
+            // MASK only gets here opaque, which premultiplying leaves alone
+            uint32_t c = target->bPremultiplied ? premultiply_px(p.n) : p.n;
+            for(int32_t i = 0; i < count; i++, line_step(&w))
+                if(rol(&pattern)) *w.d = c;
+            break;
         }
-        for (x = x1; x <= x2; x++) if (rol(&pattern)) Draw(x, y1, p);
-        return;
+        case olc_PIXELMODE_ALPHA:
+            for(int32_t i = 0; i < count; i++, line_step(&w))
+                if(rol(&pattern)) *w.d = blend_px(p.n, *w.d, PGE.nBlendFactor);
+            break;
+        case olc_PIXELMODE_CUSTOM:
+            for(int32_t i = 0; i < count; i++, line_step(&w))
+                if(rol(&pattern)) *w.d = PGE.funcPixelMode(w.x, w.y, p, olc_PixelRAW(*w.d)).n;
+            break;
+        case olc_PIXELMODE_CUSTOM_SPAN:
+            for(int32_t i = 0; i < count; i++, line_step(&w))
+                if(rol(&pattern)) PGE.funcSpanMode(w.x, w.y, &p, (olc_Pixel*)w.d, 1);
+            break;
     }
+}
 
-    // Line is Funk-aye
-    dx1 = abs(dx); dy1 = abs(dy);
-    px = 2 * dy1 - dx1;	py = 2 * dx1 - dy1;
-    if (dy1 <= dx1)
+// Locally used function, the half widths of the rows of an rx by ry ellipse.
+// A circle keeps the rows the midpoint walk has always drawn
+void ellipse_build(int32_t rx, int32_t ry, int32_t* h)
+{
+    if(rx == ry)
     {
-        if (dx >= 0)
-        { x = x1; y = y1; xe = x2; }
-        else
-        { x = x2; y = y2; xe = x1; }
+        for(int32_t t = 0; t <= ry; t++) h[t] = 0;
 
-        if (rol(&pattern)) Draw(x, y, p);
-
-        for (i = 0; x<xe; i++)
+        int32_t x0 = 0, y0 = ry, d = 3 - 2 * ry;
+        while(y0 >= x0)
         {
-            x = x + 1;
-            if (px<0)
-                px = px + 2 * dy1;
+            if(h[x0] < y0) h[x0] = y0;
+            if(d < 0)
+                d += 4 * x0++ + 6;
             else
             {
-                if ((dx<0 && dy<0) || (dx>0 && dy>0)) y = y + 1; else y = y - 1;
-                px = px + 2 * (dy1 - dx1);
+                if(x0 != y0 && h[y0] < x0) h[y0] = x0;
+                d += 4 * (x0++ - y0--) + 10;
             }
-            if (rol(&pattern)) Draw(x, y, p);
         }
+        return;
     }
-    else
+
+    // pixels whose centres lie inside the ellipse through the outer edges of
+    // the extreme pixels, (rx + 0.5) by (ry + 0.5), as the circles come out
+    double a = rx + 0.5, b = ry + 0.5;
+    for(int32_t t = 0; t <= ry; t++)
     {
-        if (dy >= 0)
-        { x = x1; y = y1; ye = y2; }
-        else
-        { x = x2; y = y2; ye = y1; }
+        h[t] = (int32_t)(a * sqrt(1.0 - (t / b) * (t / b)));
+        if(h[t] > rx) h[t] = rx;
+    }
+}
+
+// Locally used function, the largest y with y * (y - 1) < m, for m >= 0
+int64_t ellipse_rowlimit(int64_t m)
+{
+    int64_t y = (int64_t)sqrt((double)m) + 1;
+    while(y > 0 && y * (y - 1) >= m) y--;
+    while((y + 1) * y < m) y++;
+    return y;
+}
+
+// Locally used function, the half width of row t of an rx by ry ellipse worked
+// out on its own, the same as ellipse_build gives it. For a circle, the midpoint
+// walk is at height Y(x) = ellipse_rowlimit(r^2 - x^2) in column x, so row t is
+// as wide as the walk's column t reaches while above the diagonal, or as the
+// last column the walk spends at height t
+int32_t ellipse_halfwidth(int32_t rx, int32_t ry, int32_t t)
+{
+    if(rx != ry)
+    {
+        double a = rx + 0.5, b = ry + 0.5;
+        int32_t h = (int32_t)(a * sqrt(1.0 - (t / b) * (t / b)));
+        return (h > rx) ? rx : h;
+    }
+
+    int64_t r2 = (int64_t)ry * ry, h = 0;
+    int64_t y = ellipse_rowlimit(r2 - (int64_t)t * t);
+    if(y >= t) h = y;
+
+    int64_t m = r2 - (int64_t)t * (t - 1);
+    if(m > 0)
+    {
+        int64_t x = (int64_t)sqrt((double)(m - 1));
+        while(x > 0 && x * x >= m) x--;
+        while((x + 1) * (x + 1) < m) x++;
+        if(x < t && x > h && ellipse_rowlimit(r2 - x * x) == t) h = x;
+    }
 
-        if (rol(&pattern)) Draw(x, y, p);
+    return (int32_t)h;
+}
 
-        for (i = 0; y<ye; i++)
+// Locally used function, the half width table of an rx by ry ellipse, for ry up
+// to olc_nEllipseCacheMaxRadius. Recently drawn sizes are kept, the least
+// recently used one being replaced
+const int32_t* ellipse_halfwidths(int32_t rx, int32_t ry)
+{
+    olc_EllipseSpans* entry = &PGE.vEllipseCache[0];
+    for(int32_t i = 0; i < olc_nEllipseCacheSize; i++)
+    {
+        olc_EllipseSpans* e = &PGE.vEllipseCache[i];
+        if(e->halfWidths != NULL && e->rx == rx && e->ry == ry)
         {
-            y = y + 1;
-            if (py <= 0)
-                py = py + 2 * dx1;
-            else
-            {
-                if ((dx<0 && dy<0) || (dx>0 && dy>0)) x = x + 1; else x = x - 1;
-                py = py + 2 * (dx1 - dy1);
-            }
-            if (rol(&pattern)) Draw(x, y, p);
+            e->nLastUsed = ++PGE.nEllipseClock;
+            return e->halfWidths;
+        }
+        if(e->halfWidths == NULL || (entry->halfWidths != NULL && e->nLastUsed < entry->nLastUsed))
+            entry = e;
+    }
+
+    int32_t* h = olc_Realloc(entry->halfWidths, sizeof(int32_t) * ((size_t)ry + 1), olc_ALLOC_GENERAL);
+    if(h == NULL)
+    {
+        fprintf(stderr, "Failed to allocate ellipse spans\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ellipse_build(rx, ry, h);
+    entry->rx = rx;
+    entry->ry = ry;
+    entry->halfWidths = h;
+    entry->nLastUsed = ++PGE.nEllipseClock;
+    return h;
+}
+
+// Locally used function, releases every cached ellipse table
+void ellipse_freecache()
+{
+    for(int32_t i = 0; i < olc_nEllipseCacheSize; i++)
+    {
+        olc_Free(PGE.vEllipseCache[i].halfWidths);
+        PGE.vEllipseCache[i].halfWidths = NULL;
+    }
+}
+
+// Locally used function, draws the span of row y from x + l to x + r, the ends
+// clamped to just past the draw target first so they can't overflow
+void ellipse_span(int32_t x, int32_t y, int64_t l, int64_t r, olc_Pixel p)
+{
+    int64_t w = PGE.pDrawTarget->width, sx = x + l, ex = x + r;
+    drawline((int)((sx < -1) ? -1 : (sx > w) ? w : sx), (int)((ex < -1) ? -1 : (ex > w) ? w : ex), y, p);
+}
+
+// Locally used function, draws the rows of the ellipse at (x,y) that fall in
+// the draw target. Filled, each row is one span, otherwise only the pixels on
+// either side that the row below or above doesn't already cover. Small sizes
+// come from the cached tables, larger ones work out just the rows they draw
+void ellipse_rows(int32_t x, int32_t y, int32_t rx, int32_t ry, olc_Pixel p, bool bFill)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || rx < 0 || ry < 0) return;
+    if((int64_t)x + rx < 0 || (int64_t)x - rx >= target->width) return;
+    if((int64_t)y + ry < 0 || (int64_t)y - ry >= target->height) return;
+
+    const int32_t* h = (ry <= olc_nEllipseCacheMaxRadius) ? ellipse_halfwidths(rx, ry) : NULL;
+    int32_t t0 = (int32_t)(((int64_t)y - ry < 0) ? -(int64_t)y : -(int64_t)ry);
+    int32_t t1 = (int32_t)(((int64_t)y + ry >= target->height) ? (int64_t)target->height - 1 - y : ry);
+
+    for(int32_t t = t0; t <= t1; t++)
+    {
+        int32_t a = (t < 0) ? -t : t;
+        int32_t hi = (h != NULL) ? h[a] : ellipse_halfwidth(rx, ry, a);
+        int32_t lo = 0;
+        if(!bFill && a != ry) lo = ((h != NULL) ? h[a + 1] : ellipse_halfwidth(rx, ry, a + 1)) + 1;
+        if(lo > hi) lo = hi;
+
+        if(lo == 0)
+        {
+            ellipse_span(x, y + t, -(int64_t)hi, hi, p);
+        }
+        else
+        {
+            ellipse_span(x, y + t, -(int64_t)hi, -(int64_t)lo, p);
+            ellipse_span(x, y + t, lo, hi, p);
         }
     }
 }
@@ -853,6 +2601,13 @@ void DrawCircle(int32_t x, int32_t y, int32_t radius, olc_Pixel p, uint8_t mask)
     if (radius < 0 || x < -radius || y < -radius || x - GetDrawTargetWidth() > radius || y - GetDrawTargetHeight() > radius)
         return;
 
+    // the whole outline is drawn a row of spans at a time
+    if (mask == 0xFF)
+    {
+        ellipse_rows(x, y, radius, radius, p, false);
+        return;
+    }
+
     if (radius > 0)
     {
         int x0 = 0;
@@ -886,245 +2641,513 @@ void DrawCircle(int32_t x, int32_t y, int32_t radius, olc_Pixel p, uint8_t mask)
 
 // Fills a circle located at (x,y) with radius
 void FillCircle(int32_t x, int32_t y, int32_t radius, olc_Pixel p)
-{ // Thanks to IanM-Matrix1 #PR121
-    if (radius < 0 || x < -radius || y < -radius || x - GetDrawTargetWidth() > radius || y - GetDrawTargetHeight() > radius)
-        return;
+{ ellipse_rows(x, y, radius, radius, p, true); }
 
-    if (radius > 0)
+// Draws an ellipse located at (x,y) with radii rx and ry
+void DrawEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry, olc_Pixel p)
+{ ellipse_rows(x, y, rx, ry, p, false); }
+
+// Fills an ellipse located at (x,y) with radii rx and ry
+void FillEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry, olc_Pixel p)
+{ ellipse_rows(x, y, rx, ry, p, true); }
+
+// Draws a rectangle at (x,y) to (x+w,y+h)
+void DrawRect(int32_t x, int32_t y, int32_t w, int32_t h, olc_Pixel p)
+{
+    DrawLine(x, y, x+w, y, p, olc_SOLID);
+    DrawLine(x+w, y, x+w, y+h, p, olc_SOLID);
+    DrawLine(x+w, y+h, x, y+h, p, olc_SOLID);
+    DrawLine(x, y+h, x, y, p, olc_SOLID);
+}
+
+// Fills a rectangle at (x,y) to (x+w,y+h)
+void FillRect(int32_t x, int32_t y, int32_t w, int32_t h, olc_Pixel p)
+{
+    int32_t x2 = x + w;
+    int32_t y2 = y + h;
+
+    if (x < 0) x = 0;
+    if (x >= (int32_t)GetDrawTargetWidth()) x = (int32_t)GetDrawTargetWidth();
+    if (y < 0) y = 0;
+    if (y >= (int32_t)GetDrawTargetHeight()) y = (int32_t)GetDrawTargetHeight();
+
+    if (x2 < 0) x2 = 0;
+    if (x2 >= (int32_t)GetDrawTargetWidth()) x2 = (int32_t)GetDrawTargetWidth();
+    if (y2 < 0) y2 = 0;
+    if (y2 >= (int32_t)GetDrawTargetHeight()) y2 = (int32_t)GetDrawTargetHeight();
+
+    fillrows(x, y, x2 - x, y2 - y, p);
+}
+
+// Draws a triangle between points (x1,y1), (x2,y2) and (x3,y3)
+void DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc_Pixel p)
+{
+    DrawLine(x1, y1, x2, y2, p, olc_SOLID);
+    DrawLine(x2, y2, x3, y3, p, olc_SOLID);
+    DrawLine(x3, y3, x1, y1, p, olc_SOLID);
+}
+
+// Locally used, the edges of a triangle in fixed point, stepped a row at a
+// time to give the run of pixels whose centres it covers. A centre exactly on
+// an edge belongs to the triangle only on a top or left edge, so triangles
+// sharing an edge never both draw it
+typedef struct
+{
+    int64_t a[3], m[3], n[3], q[3], r[3], dq[3], dr[3];
+    int32_t y, yEnd, width;
+} TriangleEdges;
+
+// Locally used function, sets up the edges of the triangle (X,Y), given with
+// nShift fraction bits and wound so its area is positive, from its first row
+// inside target. False if it has none
+bool triangle_edges(TriangleEdges* e, const int64_t X[3], const int64_t Y[3], int32_t nShift, olc_Sprite* target)
+{
+    int64_t s = (int64_t)1 << nShift, half = s >> 1;
+    int64_t yMin = (Y[0] < Y[1]) ? ((Y[0] < Y[2]) ? Y[0] : Y[2]) : ((Y[1] < Y[2]) ? Y[1] : Y[2]);
+    int64_t yMax = (Y[0] > Y[1]) ? ((Y[0] > Y[2]) ? Y[0] : Y[2]) : ((Y[1] > Y[2]) ? Y[1] : Y[2]);
+    int64_t y0 = floordiv64(yMin, s), y1 = floordiv64(yMax, s);
+    if(y0 < 0) y0 = 0;
+    if(y1 > target->height - 1) y1 = target->height - 1;
+    if(y0 > y1) return false;
+
+    e->y = (int32_t)y0;
+    e->yEnd = (int32_t)y1;
+    e->width = target->width;
+
+    // for edge a->b, the centre of pixel (x,y) is inside when A (cx - ax) +
+    // B (cy - ay) - bias >= 0. Along a row that bounds x by -/+ floor(N / |A|s),
+    // kept as a quotient and remainder that step by Bs each row
+    for(int i = 0; i < 3; i++)
     {
-        int x0 = 0;
-        int y0 = radius;
-        int d = 3 - 2 * radius;
+        int j = (i + 1) % 3;
+        int64_t A = Y[i] - Y[j], B = X[j] - X[i];
+        // top edges run along +x and left edges up the screen with this winding
+        int64_t bias = ((A == 0 && B > 0) || A > 0) ? 0 : 1;
+
+        e->a[i] = A;
+        e->n[i] = A * (half - X[i]) + B * (y0 * s + half - Y[i]) - bias;
+        if(A == 0) { e->dq[i] = B * s; continue; }
+
+        e->m[i] = ((A > 0) ? A : -A) * s;
+        e->q[i] = floordiv64(e->n[i], e->m[i]); e->r[i] = e->n[i] - e->q[i] * e->m[i];
+        e->dq[i] = floordiv64(B * s, e->m[i]);  e->dr[i] = B * s - e->dq[i] * e->m[i];
+    }
+    return true;
+}
+
+// Locally used function, the run [*xl, *xr] of the current row e->y, clipped
+// to the target and possibly empty, then moves on a row. False past the last
+bool triangle_next(TriangleEdges* e, int32_t* xl, int32_t* xr)
+{
+    if(e->y > e->yEnd) return false;
+
+    int64_t l = 0, r = e->width - 1;
+    for(int i = 0; i < 3; i++)
+    {
+        if(e->a[i] == 0)
+        {
+            // a horizontal edge only cuts off whole rows
+            if(e->n[i] < 0) r = -1;
+            e->n[i] += e->dq[i];
+            continue;
+        }
+
+        if(e->a[i] > 0) { if(-e->q[i] > l) l = -e->q[i]; }
+        else            { if(e->q[i] < r)  r = e->q[i]; }
+
+        e->q[i] += e->dq[i]; e->r[i] += e->dr[i];
+        if(e->r[i] >= e->m[i]) { e->r[i] -= e->m[i]; e->q[i]++; }
+    }
+
+    *xl = (int32_t)l;
+    *xr = (int32_t)((r < l) ? l - 1 : r);
+    e->y++;
+    return true;
+}
+
+// Fills a triangle between points (x1,y1), (x2,y2) and (x3,y3). A pixel is
+// drawn when it lies inside all three edges, or exactly on a top or left edge,
+// so triangles sharing an edge never both draw it and a triangle with no area
+// draws nothing. Each row inside the draw target is one run for fillrows
+void FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc_Pixel p)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL) return;
+
+    // vertices are held within 2^22 pixels of the origin, as DrawTriangles holds
+    // its own, so the area and edge terms below stay well inside 64 bits. Only
+    // a triangle reaching further off the target than that changes shape
+    int32_t* c[6] = { &x1, &y1, &x2, &y2, &x3, &y3 };
+    for(int i = 0; i < 6; i++)
+        *c[i] = (*c[i] < -4194304) ? -4194304 : (*c[i] > 4194304) ? 4194304 : *c[i];
+
+    // wind the vertices so the area is positive
+    int64_t area = ((int64_t)x2 - x1) * ((int64_t)y3 - y1) - ((int64_t)y2 - y1) * ((int64_t)x3 - x1);
+    if(area == 0) return;
+    if(area < 0) { swap_int(&x2, &x3); swap_int(&y2, &y3); }
+
+    // pixel (x,y) has its centre at (2x + 1, 2y + 1) in half pixels
+    int64_t X[3] = { 2 * (int64_t)x1 + 1, 2 * (int64_t)x2 + 1, 2 * (int64_t)x3 + 1 };
+    int64_t Y[3] = { 2 * (int64_t)y1 + 1, 2 * (int64_t)y2 + 1, 2 * (int64_t)y3 + 1 };
+
+    TriangleEdges e;
+    int32_t xl, xr;
+    if(!triangle_edges(&e, X, Y, 1, target)) return;
+    while(triangle_next(&e, &xl, &xr))
+        fillrows(xl, e.y - 1, xr - xl + 1, 1, p);
+}
+
+// Locally used function, orders polygon edges by their first row for qsort
+int polygonedge_compare(const void* a, const void* b)
+{
+    int32_t ya = ((const olc_PolygonEdge*)a)->yStart, yb = ((const olc_PolygonEdge*)b)->yStart;
+    return (ya > yb) - (ya < yb);
+}
+
+// Fills the polygon through count points, which may be concave or cross itself,
+// with olc_FILLRULE_EVENODD or olc_FILLRULE_NONZERO deciding what is inside.
+// Pixels on its edges follow FillTriangle's top-left rule. Rows are filled from
+// an edge table sorted by first row and a list of the edges crossing the row,
+// so each row inside the draw target is visited once and its runs filled once
+void FillPolygon(const olc_vi2d* points, uint32_t count, olc_Pixel p, uint32_t rule)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || points == NULL || count < 3) return;
+
+    if(count > PGE.nPolygonScratch)
+    {
+        olc_PolygonEdge* edges = olc_Realloc(PGE.pPolygonEdges, sizeof(olc_PolygonEdge) * count, olc_ALLOC_GENERAL);
+        uint32_t* active = (edges != NULL) ? olc_Realloc(PGE.pPolygonActive, sizeof(uint32_t) * count, olc_ALLOC_GENERAL) : NULL;
+        if(active == NULL)
+        {
+            fprintf(stderr, "Failed to allocate polygon edges\n");
+            exit(EXIT_FAILURE);
+        }
+        PGE.pPolygonEdges = edges;
+        PGE.pPolygonActive = active;
+        PGE.nPolygonScratch = count;
+    }
+
+    // Each edge covers the rows whose centres lie in [top, bottom). Point (x,y)
+    // is the pixel centre (2x + 1, 2y + 1) in half pixels, and the row's run
+    // begins or ends at the first pixel whose centre is not left of the edge,
+    // ceil(N / d) with N = (X0 - 1) d + (cy - Y0) dX and d = 2 dY, which steps
+    // by 2 dX a row and is kept as a quotient and remainder
+    olc_PolygonEdge* edges = PGE.pPolygonEdges;
+    uint32_t nEdges = 0;
+    for(uint32_t i = 0; i < count; i++)
+    {
+        const olc_vi2d* a = &points[i];
+        const olc_vi2d* b = &points[(i + 1) % count];
+        if(a->y == b->y) continue;
+
+        int32_t winding = (a->y < b->y) ? 1 : -1;
+        if(winding < 0) { const olc_vi2d* t = a; a = b; b = t; }
+
+        int32_t y0 = (a->y > 0) ? a->y : 0;
+        int32_t y1 = (b->y < target->height) ? b->y : target->height;
+        if(y0 >= y1) continue;
+
+        int64_t X0 = 2 * (int64_t)a->x + 1, dX = 2 * ((int64_t)b->x - a->x), dY = 2 * ((int64_t)b->y - a->y);
+        int64_t d = 2 * dY;
+        int64_t n = (X0 - 1) * dY + 2 * ((int64_t)y0 - a->y) * dX + d - 1;
+
+        olc_PolygonEdge* e = &edges[nEdges++];
+        e->yStart = y0;
+        e->yEnd = y1;
+        e->winding = winding;
+        e->d = d;
+        e->q = floordiv64(n, d);      e->r = n - e->q * d;
+        e->dq = floordiv64(2 * dX, d); e->dr = 2 * dX - e->dq * d;
+    }
+    if(nEdges == 0) return;
+
+    qsort(edges, nEdges, sizeof(olc_PolygonEdge), polygonedge_compare);
+
+    uint32_t* active = PGE.pPolygonActive;
+    uint32_t nActive = 0, next = 0;
+    for(int32_t y = edges[0].yStart; nActive > 0 || next < nEdges; y++)
+    {
+        // jump over rows no edge crosses
+        if(nActive == 0 && edges[next].yStart > y) y = edges[next].yStart;
+        while(next < nEdges && edges[next].yStart == y) active[nActive++] = next++;
+
+        // keep the list in order of where the edges cross the row; from one row
+        // to the next it barely changes, so an insertion sort is all it takes
+        for(uint32_t i = 1; i < nActive; i++)
+        {
+            uint32_t k = active[i], j = i;
+            for(; j > 0 && edges[active[j - 1]].q > edges[k].q; j--) active[j] = active[j - 1];
+            active[j] = k;
+        }
 
-        while (y0 >= x0)
+        int32_t wind = 0;
+        for(uint32_t i = 0; i + 1 < nActive; i++)
         {
-            drawline(x - y0, x + y0,y - x0, p);
-            if (x0 > 0)	drawline(x - y0, x + y0, y + x0, p);
+            wind += (rule == olc_FILLRULE_NONZERO) ? edges[active[i]].winding : 1;
+            bool bInside = (rule == olc_FILLRULE_NONZERO) ? (wind != 0) : (wind & 1);
+            if(!bInside) continue;
+
+            int64_t xl = edges[active[i]].q, xr = edges[active[i + 1]].q - 1;
+            if(xl < 0) xl = 0;
+            if(xr > target->width - 1) xr = target->width - 1;
+            if(xl <= xr) fillrows((int32_t)xl, y, (int32_t)(xr - xl + 1), 1, p);
+        }
 
-            if (d < 0)
-                d += 4 * x0++ + 6;
-            else
-            {
-                if (x0 != y0)
-                {
-                    drawline(x - x0, x + x0, y - y0, p);
-                    drawline(x - x0, x + x0, y + y0, p);
-                }
-                d += 4 * (x0++ - y0--) + 10;
-            }
+        // step the edges on a row, dropping those that end
+        uint32_t kept = 0;
+        for(uint32_t i = 0; i < nActive; i++)
+        {
+            olc_PolygonEdge* e = &edges[active[i]];
+            if(y + 1 >= e->yEnd) continue;
+            e->q += e->dq; e->r += e->dr;
+            if(e->r >= e->d) { e->r -= e->d; e->q++; }
+            active[kept++] = active[i];
         }
+        nActive = kept;
     }
-    else
-        Draw(x, y, p);
 }
 
-// Draws a rectangle at (x,y) to (x+w,y+h)
-void DrawRect(int32_t x, int32_t y, int32_t w, int32_t h, olc_Pixel p)
+// Locally used function, is pixel c within tolerance of seed on every channel?
+static inline bool flood_match(uint32_t c, uint32_t seed, uint32_t tolerance)
 {
-    DrawLine(x, y, x+w, y, p, olc_SOLID);
-    DrawLine(x+w, y, x+w, y+h, p, olc_SOLID);
-    DrawLine(x+w, y+h, x, y+h, p, olc_SOLID);
-    DrawLine(x, y+h, x, y, p, olc_SOLID);
+    if(tolerance == 0) return c == seed;
+    for(int s = 0; s < 32; s += 8)
+    {
+        int32_t d = (int32_t)((c >> s) & 0xFF) - (int32_t)((seed >> s) & 0xFF);
+        if((uint32_t)(d < 0 ? -d : d) > tolerance) return false;
+    }
+    return true;
 }
 
-// Fills a rectangle at (x,y) to (x+w,y+h)
-void FillRect(int32_t x, int32_t y, int32_t w, int32_t h, olc_Pixel p)
+// Locally used function, queues row y between xl and xr to be looked along
+static inline void flood_push(int32_t xl, int32_t xr, int32_t y)
 {
-    int32_t x2 = x + w;
-    int32_t y2 = y + h;
-
-    if (x < 0) x = 0;
-    if (x >= (int32_t)GetDrawTargetWidth()) x = (int32_t)GetDrawTargetWidth();
-    if (y < 0) y = 0;
-    if (y >= (int32_t)GetDrawTargetHeight()) y = (int32_t)GetDrawTargetHeight();
-
-    if (x2 < 0) x2 = 0;
-    if (x2 >= (int32_t)GetDrawTargetWidth()) x2 = (int32_t)GetDrawTargetWidth();
-    if (y2 < 0) y2 = 0;
-    if (y2 >= (int32_t)GetDrawTargetHeight()) y2 = (int32_t)GetDrawTargetHeight();
+    if(PGE.nFloodSpans == PGE.nFloodSpanCapacity)
+    {
+        uint32_t capacity = (PGE.nFloodSpanCapacity > 0) ? PGE.nFloodSpanCapacity * 2 : 256;
+        olc_FloodSpan* spans = olc_Realloc(PGE.pFloodSpans, sizeof(olc_FloodSpan) * capacity, olc_ALLOC_GENERAL);
+        if(spans == NULL)
+        {
+            fprintf(stderr, "Failed to allocate flood fill spans\n");
+            exit(EXIT_FAILURE);
+        }
+        PGE.pFloodSpans = spans;
+        PGE.nFloodSpanCapacity = capacity;
+    }
 
-    for (int i = x; i < x2; i++)
-        for (int j = y; j < y2; j++)
-            Draw(i, j, p);
+    olc_FloodSpan* s = &PGE.pFloodSpans[PGE.nFloodSpans++];
+    s->xl = xl; s->xr = xr; s->y = y;
 }
 
-// Draws a triangle between points (x1,y1), (x2,y2) and (x3,y3)
-void DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc_Pixel p)
+// Fills the region of pixels joined to (x,y) across their edges whose colour
+// is within tolerance, on every channel, of the colour at (x,y), drawing it in
+// the current pixel mode. Works a row run at a time: each run is grown out to
+// both ends, filled, and the rows above and below it queued on a span stack
+// to be looked along in turn, so no pixel is visited more than a few times
+void FloodFill(int32_t x, int32_t y, olc_Pixel p, uint32_t tolerance)
 {
-    DrawLine(x1, y1, x2, y2, p, olc_SOLID);
-    DrawLine(x2, y2, x3, y3, p, olc_SOLID);
-    DrawLine(x3, y3, x1, y1, p, olc_SOLID);
-}
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || x < 0 || y < 0 || x >= target->width || y >= target->height) return;
 
-// https://www.avrfreaks.net/sites/default/files/triangles.c
-void FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc_Pixel p)
-{
-    int t1x, t2x, y, minx, maxx, t1xp, t2xp;
-    bool changed1 = false;
-    bool changed2 = false;
-    int signx1, signx2, dx1, dy1, dx2, dy2;
-    int e1, e2;
-    // Sort vertices
-    if (y1>y2) {swap_int(&y1, &y2); swap_int(&x1, &x2); }
-    if (y1>y3) {swap_int(&y1, &y3); swap_int(&x1, &x3); }
-    if (y2>y3) {swap_int(&y2, &y3); swap_int(&x2, &x3); }
-
-    t1x = t2x = x1; y = y1;   // Starting points
-    dx1 = (int)(x2 - x1);
-    if (dx1<0) { dx1 = -dx1; signx1 = -1; }	else signx1 = 1;
-    dy1 = (int)(y2 - y1);
-
-    dx2 = (int)(x3 - x1);
-    if (dx2<0) { dx2 = -dx2; signx2 = -1; } else signx2 = 1;
-    dy2 = (int)(y3 - y1);
-
-    if (dy1 > dx1) { swap_int(&dx1, &dy1); changed1 = true; }
-    if (dy2 > dx2) { swap_int(&dy2, &dx2); changed2 = true; }
-
-    e2 = (int)(dx2 >> 1);
-    // Flat top, just process the second half
-    if (y1 == y2) goto next;
-    e1 = (int)(dx1 >> 1);
-
-    for (int i = 0; i < dx1;) {
-        t1xp = 0; t2xp = 0;
-        if (t1x<t2x) { minx = t1x; maxx = t2x; }
-        else { minx = t2x; maxx = t1x; }
-        // process first line until y value is about to change
-        while (i<dx1) {
-            i++;
-            e1 += dy1;
-            while (e1 >= dx1) {
-                e1 -= dx1;
-                if (changed1) t1xp = signx1;//t1x += signx1;
-                else          goto next1;
-            }
-            if (changed1) break;
-            else t1x += signx1;
-        }
-        // Move line
-    next1:
-        // process second line until y value is about to change
-        while (1) {
-            e2 += dy2;
-            while (e2 >= dx2) {
-                e2 -= dx2;
-                if (changed2) t2xp = signx2;//t2x += signx2;
-                else          goto next2;
-            }
-            if (changed2)     break;
-            else              t2x += signx2;
-        }
-    next2:
-        if (minx>t1x) minx = t1x;
-        if (minx>t2x) minx = t2x;
-        if (maxx<t1x) maxx = t1x;
-        if (maxx<t2x) maxx = t2x;
-        drawline(minx, maxx, y, p);    // Draw line from min to max points found on the y
-                                    // Now increase y
-        if (!changed1) t1x += signx1;
-        t1x += t1xp;
-        if (!changed2) t2x += signx2;
-        t2x += t2xp;
-        y += 1;
-        if (y == y2) break;
-
-    }
-next:
-    // Second half
-    dx1 = (int)(x3 - x2); if (dx1<0) { dx1 = -dx1; signx1 = -1; }
-    else signx1 = 1;
-    dy1 = (int)(y3 - y2);
-    t1x = x2;
-
-    if (dy1 > dx1) {   // swap values
-        swap_int(&dy1, &dx1);
-        changed1 = true;
-    }
-    else changed1 = false;
-
-    e1 = (int)(dx1 >> 1);
-
-    for (int i = 0; i <= dx1; i++) {
-        t1xp = 0; t2xp = 0;
-        if (t1x<t2x) { minx = t1x; maxx = t2x; }
-        else { minx = t2x; maxx = t1x; }
-        // process first line until y value is about to change
-        while (i<dx1) {
-            e1 += dy1;
-            while (e1 >= dx1) {
-                e1 -= dx1;
-                if (changed1) { t1xp = signx1; break; }//t1x += signx1;
-                else          goto next3;
-            }
-            if (changed1) break;
-            else   	   	  t1x += signx1;
-            if (i<dx1) i++;
-        }
-    next3:
-        // process second line until y value is about to change
-        while (t2x != x3) {
-            e2 += dy2;
-            while (e2 >= dx2) {
-                e2 -= dx2;
-                if (changed2) t2xp = signx2;
-                else          goto next4;
+    // pixels filled by this call are stamped, so whatever the pixel mode leaves
+    // there they aren't taken again. A new stamp each call saves clearing them
+    size_t size = (size_t)target->width * target->height;
+    if(size > PGE.nFloodStampSize || ++PGE.nFloodStamp == 0)
+    {
+        if(size > PGE.nFloodStampSize)
+        {
+            uint8_t* stamps = olc_Realloc(PGE.pFloodStamps, size, olc_ALLOC_GENERAL);
+            if(stamps == NULL)
+            {
+                fprintf(stderr, "Failed to allocate flood fill stamps\n");
+                exit(EXIT_FAILURE);
             }
-            if (changed2)     break;
-            else              t2x += signx2;
+            PGE.pFloodStamps = stamps;
+            PGE.nFloodStampSize = size;
         }
-    next4:
-
-        if (minx>t1x) minx = t1x;
-        if (minx>t2x) minx = t2x;
-        if (maxx<t1x) maxx = t1x;
-        if (maxx<t2x) maxx = t2x;
-        drawline(minx, maxx, y, p);
-        if (!changed1) t1x += signx1;
-        t1x += t1xp;
-        if (!changed2) t2x += signx2;
-        t2x += t2xp;
-        y += 1;
-        if (y>y3) return;
+        memset(PGE.pFloodStamps, 0, PGE.nFloodStampSize);
+        PGE.nFloodStamp = 1;
     }
 
+    uint8_t stamp = PGE.nFloodStamp;
+    uint32_t seed = target->pixels[y * target->stride + x];
+    PGE.nFloodSpans = 0;
+    flood_push(x, x, y);
+
+    while(PGE.nFloodSpans > 0)
+    {
+        olc_FloodSpan s = PGE.pFloodSpans[--PGE.nFloodSpans];
+        if(s.y < 0 || s.y >= target->height) continue;
+
+        const uint32_t* row = target->pixels + s.y * target->stride;
+        uint8_t* done = PGE.pFloodStamps + (size_t)s.y * target->width;
+
+        for(int32_t i = s.xl; i <= s.xr; i++)
+        {
+            if(done[i] == stamp || !flood_match(row[i], seed, tolerance)) continue;
+
+            // grow the run out to both ends, past the span it was found from
+            int32_t a = i, b = i;
+            while(a > 0 && done[a - 1] != stamp && flood_match(row[a - 1], seed, tolerance)) a--;
+            while(b < target->width - 1 && done[b + 1] != stamp && flood_match(row[b + 1], seed, tolerance)) b++;
+
+            memset(done + a, stamp, (size_t)(b - a + 1));
+            fillrows(a, s.y, b - a + 1, 1, p);
+            flood_push(a, b, s.y - 1);
+            flood_push(a, b, s.y + 1);
+            i = b;
+        }
+    }
 }
 
-// Draws an entire sprite at well in my defencelocation (x,y)
-void DrawSprite(int32_t x, int32_t y, olc_Sprite *sprite, uint32_t scale, uint8_t flip)
+// Draws the indexed triangles of a mesh, three indices to a triangle, count
+// being the number of indices. Colours are interpolated across each triangle
+// and, given a sprite, modulate its texels, with uv corrected for perspective
+// by each vertex's w. Vertices are set up once however many triangles use them
+void DrawTriangles(const olc_Vertex* vertices, uint32_t nVertices, const uint32_t* indices, uint32_t count, olc_Sprite* sprite)
 {
-    if (sprite == NULL)
-        return;
+    olc_Sprite* target = PGE.pDrawTarget;
+    if(target == NULL || vertices == NULL || indices == NULL || count < 3) return;
+    count -= count % 3;
 
-    int32_t fxs = 0, fxm = 1, fx = 0;
-    int32_t fys = 0, fym = 1, fy = 0;
-    
-    if (flip & olc_SPRITEFLIP_HORIZ) { fxs = sprite->width - 1; fxm = -1; }
-    if (flip & olc_SPRITEFLIP_VERT) { fys = sprite->height - 1; fym = -1; }
+    // set up only the vertices the indices reach, out of range ones reach nothing
+    uint32_t nUsed = 0;
+    for(uint32_t i = 0; i < count; i++)
+        if(indices[i] < nVertices && indices[i] >= nUsed) nUsed = indices[i] + 1;
+    if(nUsed == 0) return;
 
-    if (scale > 1)
+    if(nUsed > PGE.nMeshScratch)
     {
-        fx = fxs;
-        for (int32_t i = 0; i < sprite->width; i++, fx += fxm)
+        olc_MeshVertex* scratch = olc_Realloc(PGE.pMeshScratch, sizeof(olc_MeshVertex) * nUsed, olc_ALLOC_GENERAL);
+        if(scratch == NULL)
         {
-            fy = fys;
-            for (int32_t j = 0; j < sprite->height; j++, fy += fym)
-                for (uint32_t is = 0; is < scale; is++)
-                    for (uint32_t js = 0; js < scale; js++)
-                        Draw(x + (i*scale) + is, y + (j*scale) + js, olc_Sprite_GetPixel(sprite, fx, fy));
+            fprintf(stderr, "Failed to allocate mesh vertices\n");
+            exit(EXIT_FAILURE);
         }
+        PGE.pMeshScratch = scratch;
+        PGE.nMeshScratch = nUsed;
     }
-    else
+
+    // positions go to 24.8 fixed-point, clamped well inside what the edge
+    // arithmetic can hold, and every attribute is divided by w. A vertex at
+    // w <= 0 (or NaN) is behind the eye, and gets 1/w = 0 to mark it
+    bool bTint = false;
+    for(uint32_t i = 0; i < nUsed; i++)
+    {
+        const olc_Vertex* v = &vertices[i];
+        olc_MeshVertex* o = &PGE.pMeshScratch[i];
+        float iw = (v->w > 0.0f) ? 1.0f / v->w : 0.0f;
+        float px = fminf(fmaxf(v->pos.x, -4194304.0f), 4194304.0f);
+        float py = fminf(fmaxf(v->pos.y, -4194304.0f), 4194304.0f);
+        o->X = llroundf(px * 256.0f);
+        o->Y = llroundf(py * 256.0f);
+        o->f[0] = iw;
+        o->f[1] = v->uv.x * iw;
+        o->f[2] = v->uv.y * iw;
+        o->f[3] = v->col.r * iw;
+        o->f[4] = v->col.g * iw;
+        o->f[5] = v->col.b * iw;
+        o->f[6] = v->col.a * iw;
+        if(v->col.n != olc_WHITE.n) bTint = true;
+    }
+
+    bool bPremultiplied = (sprite != NULL) && sprite->bPremultiplied;
+    uint32_t wrap = (sprite != NULL && sprite->modeSample == olc_SPRITEMODE_PERIODIC) ? olc_SPRITEWRAP_REPEAT : olc_SPRITEWRAP_CLAMP;
+    uint32_t run[256];
+
+    for(uint32_t t = 0; t < count; t += 3)
     {
-        fx = fxs;
-        for (int32_t i = 0; i < sprite->width; i++, fx += fxm)
+        if(indices[t] >= nVertices || indices[t + 1] >= nVertices || indices[t + 2] >= nVertices) continue;
+        const olc_MeshVertex* v[3] = { &PGE.pMeshScratch[indices[t]], &PGE.pMeshScratch[indices[t + 1]], &PGE.pMeshScratch[indices[t + 2]] };
+
+        // a triangle reaching behind the eye would need clipping, so it is culled
+        if(!(v[0]->f[0] > 0.0f && v[1]->f[0] > 0.0f && v[2]->f[0] > 0.0f)) continue;
+
+        // either winding is drawn, turned round so the area is positive
+        int64_t area = (v[1]->X - v[0]->X) * (v[2]->Y - v[0]->Y) - (v[1]->Y - v[0]->Y) * (v[2]->X - v[0]->X);
+        if(area == 0) continue;
+        if(area < 0) { const olc_MeshVertex* tmp = v[1]; v[1] = v[2]; v[2] = tmp; area = -area; }
+
+        int64_t X[3] = { v[0]->X, v[1]->X, v[2]->X }, Y[3] = { v[0]->Y, v[1]->Y, v[2]->Y };
+        TriangleEdges e;
+        int32_t xl, xr;
+        if(!triangle_edges(&e, X, Y, 8, target)) continue;
+
+        // each attribute is a plane f0 + dfdx (x - x0) + dfdy (y - y0) over the triangle
+        float x0 = X[0] / 256.0f, y0 = Y[0] / 256.0f;
+        float ex1 = (X[1] - X[0]) / 256.0f, ey1 = (Y[1] - Y[0]) / 256.0f;
+        float ex2 = (X[2] - X[0]) / 256.0f, ey2 = (Y[2] - Y[0]) / 256.0f;
+        float inv = 65536.0f / (float)area;
+        float dfdx[7], dfdy[7];
+        for(int k = 0; k < 7; k++)
+        {
+            float d1 = v[1]->f[k] - v[0]->f[k], d2 = v[2]->f[k] - v[0]->f[k];
+            dfdx[k] = (d1 * ey2 - d2 * ey1) * inv;
+            dfdy[k] = (d2 * ex1 - d1 * ex2) * inv;
+        }
+
+        while(triangle_next(&e, &xl, &xr))
         {
-            fy = fys;
-            for (int32_t j = 0; j < sprite->height; j++, fy += fym)
-                Draw(x + i, y + j, olc_Sprite_GetPixel(sprite, fx, fy));
+            int32_t y = e.y - 1;
+            uint32_t* dst = target->pixels + y * target->stride;
+
+            for(int32_t xs = xl; xs <= xr; xs += 256)
+            {
+                int32_t chunk = (xr - xs + 1 < 256) ? xr - xs + 1 : 256;
+
+                // attributes at the centre of the first pixel, then stepped along
+                float cx = xs + 0.5f - x0, cy = y + 0.5f - y0, f[7];
+                for(int k = 0; k < 7; k++) f[k] = v[0]->f[k] + dfdx[k] * cx + dfdy[k] * cy;
+
+                for(int32_t i = 0; i < chunk; i++)
+                {
+                    float w = 1.0f / f[0];
+                    olc_Pixel c = olc_WHITE;
+                    if(bTint || sprite == NULL)
+                    {
+                        c = olc_PixelRGBA((uint8_t)fminf(fmaxf(f[3] * w + 0.5f, 0.0f), 255.0f), (uint8_t)fminf(fmaxf(f[4] * w + 0.5f, 0.0f), 255.0f),
+                                          (uint8_t)fminf(fmaxf(f[5] * w + 0.5f, 0.0f), 255.0f), (uint8_t)fminf(fmaxf(f[6] * w + 0.5f, 0.0f), 255.0f));
+                    }
+
+                    if(sprite == NULL)
+                    {
+                        run[i] = c.n;
+                    }
+                    else
+                    {
+                        float u = fminf(fmaxf(f[1] * w * sprite->width, -1073741824.0f), 1073741824.0f);
+                        float vv = fminf(fmaxf(f[2] * w * sprite->height, -1073741824.0f), 1073741824.0f);
+                        olc_Pixel s = olc_PixelRAW(sprite->pixels[wrap_texel((int64_t)floorf(vv), sprite->height, wrap) * sprite->stride + wrap_texel((int64_t)floorf(u), sprite->width, wrap)]);
+
+                        if(bTint)
+                        {
+                            // a premultiplied texel takes the colour's alpha on its colour too
+                            if(bPremultiplied) c = olc_PixelRGBA(olc_MUL255(c.r, c.a), olc_MUL255(c.g, c.a), olc_MUL255(c.b, c.a), c.a);
+                            s = olc_PixelRGBA(olc_MUL255(s.r, c.r), olc_MUL255(s.g, c.g), olc_MUL255(s.b, c.b), olc_MUL255(s.a, c.a));
+                        }
+                        run[i] = s.n;
+                    }
+
+                    for(int k = 0; k < 7; k++) f[k] += dfdx[k];
+                }
+
+                blitspan(dst + xs, run, chunk, xs, y, bPremultiplied);
+            }
         }
     }
+}
+
+// Draws an entire sprite at well in my defencelocation (x,y)
+void DrawSprite(int32_t x, int32_t y, olc_Sprite *sprite, uint32_t scale, uint8_t flip)
+{
+    if (sprite == NULL)
+        return;
 
+    if (scale > 1)
+        blitscaled(x, y, sprite, 0, 0, sprite->width, sprite->height, (int32_t)scale, flip);
+    else
+        blitrows(x, y, sprite, 0, 0, sprite->width, sprite->height, flip);
 }
 
 // Draws an area of a sprite at location (x,y), where the
@@ -1134,34 +3157,129 @@ void DrawPartialSprite(int32_t x, int32_t y, olc_Sprite *sprite, int32_t ox, int
     if (sprite == NULL)
         return;
 
-    int32_t fxs = 0, fxm = 1, fx = 0;
-    int32_t fys = 0, fym = 1, fy = 0;
-    if (flip & olc_SPRITEFLIP_HORIZ) { fxs = w - 1; fxm = -1; }
-    if (flip & olc_SPRITEFLIP_VERT) { fys = h - 1; fym = -1; }
-
     if (scale > 1)
+        blitscaled(x, y, sprite, ox, oy, w, h, (int32_t)scale, flip);
+    else
+        blitrows(x, y, sprite, ox, oy, w, h, flip);
+}
+
+// Locally used function, narrows the steps [*k0, *k1) of s + k * ds down to
+// those where lo <= s + k * ds < hi
+void ddarange(int64_t s, int64_t ds, int64_t lo, int64_t hi, int32_t* k0, int32_t* k1)
+{
+    int64_t a, b;
+    if(ds == 0)
+    {
+        if(s < lo || s >= hi) *k1 = *k0;
+        return;
+    }
+
+    if(ds > 0) { a = floordiv64(lo - s + ds - 1, ds); b = floordiv64(hi - 1 - s, ds) + 1; }
+    else       { a = floordiv64(s - hi, -ds) + 1;     b = floordiv64(s - lo, -ds) + 1; }
+
+    if(a > *k0) *k0 = (a < *k1) ? (int32_t)a : *k1;
+    if(b < *k1) *k1 = (b > *k0) ? (int32_t)b : *k0;
+}
+
+// Draws a sprite placed by an affine transform from sprite pixel space to
+// draw target space, so it can be rotated, scaled by any amount or sheared
+void DrawTransformedSprite(olc_Sprite* sprite, olc_Transform2D transform, uint32_t filter)
+{
+    olc_Sprite* target = PGE.pDrawTarget;
+    olc_Transform2D inv;
+    if(target == NULL || sprite == NULL || sprite->width <= 0 || sprite->height <= 0) return;
+    if(!olc_Transform2D_Invert(transform, &inv)) return;
+
+    // when shrinking, draw from the mip level whose texels are about a target
+    // pixel apart, its pixel space scaled back up to the sprite's first
+    if(filter & olc_SPRITEFILTER_MIPMAP)
     {
-        fx = fxs;
-        for (int32_t i = 0; i < w; i++, fx += fxm)
+        float fStep = fmaxf(hypotf(inv.m[0][0], inv.m[1][0]), hypotf(inv.m[0][1], inv.m[1][1]));
+        uint32_t level = 0;
+        for(; fStep >= 2.0f && level < 31; fStep *= 0.5f) level++;
+
+        olc_Sprite* mip = olc_Sprite_GetMip(sprite, level);
+        if(mip != sprite)
         {
-            fy = fys;
-            for (int32_t j = 0; j < h; j++, fy += fym)
-                for (uint32_t is = 0; is < scale; is++)
-                    for (uint32_t js = 0; js < scale; js++)
-                        Draw(x + (i*scale) + is, y + (j*scale) + js, olc_Sprite_GetPixel(sprite, fx + ox, fy + oy));
+            olc_Transform2D up = olc_Transform2D_Scale(olc_Transform2D_Identity(), (float)sprite->width / mip->width, (float)sprite->height / mip->height);
+            transform = Transform2D_Then(up, transform);
+            sprite = mip;
+            if(!olc_Transform2D_Invert(transform, &inv)) return;
         }
     }
-    else
+
+    // bounding box of the transformed sprite, clipped to the target
+    float fMinX = INFINITY, fMinY = INFINITY, fMaxX = -INFINITY, fMaxY = -INFINITY;
+    for(int i = 0; i < 4; i++)
+    {
+        olc_vf2d c = olc_Transform2D_Forward(transform, olc_VF2D((i & 1) ? (float)sprite->width : 0.0f, (i & 2) ? (float)sprite->height : 0.0f));
+        fMinX = fminf(fMinX, c.x); fMaxX = fmaxf(fMaxX, c.x);
+        fMinY = fminf(fMinY, c.y); fMaxY = fmaxf(fMaxY, c.y);
+    }
+
+    int32_t x0 = (fMinX > 0.0f) ? (int32_t)fminf(floorf(fMinX), (float)target->width) : 0;
+    int32_t y0 = (fMinY > 0.0f) ? (int32_t)fminf(floorf(fMinY), (float)target->height) : 0;
+    int32_t x1 = (fMaxX < (float)target->width)  ? (int32_t)fmaxf(ceilf(fMaxX), 0.0f) : target->width;
+    int32_t y1 = (fMaxY < (float)target->height) ? (int32_t)fmaxf(ceilf(fMaxY), 0.0f) : target->height;
+    if(x0 >= x1 || y0 >= y1) return;
+
+    // source coordinates step by a constant amount per target pixel, in 16.16
+    // fixed-point. Only row starts come from the inverse transform
+    const double fx = 65536.0;
+    int64_t du = llround(inv.m[0][0] * fx), dv = llround(inv.m[1][0] * fx);
+    int64_t wMax = (int64_t)sprite->width << 16, hMax = (int64_t)sprite->height << 16;
+    uint32_t buffer[256];
+
+    for(int32_t y = y0; y < y1; y++)
     {
-        fx = fxs;
-        for (int32_t i = 0; i < w; i++, fx += fxm)
+        // source position of the centre of target pixel (x0, y)
+        double px = x0 + 0.5, py = y + 0.5;
+        int64_t u = llround((inv.m[0][0] * px + inv.m[0][1] * py + inv.m[0][2]) * fx);
+        int64_t v = llround((inv.m[1][0] * px + inv.m[1][1] * py + inv.m[1][2]) * fx);
+
+        // the run of this row that falls on the sprite, worked out exactly
+        int32_t k0 = 0, k1 = x1 - x0;
+        ddarange(u, du, 0, wMax, &k0, &k1);
+        ddarange(v, dv, 0, hMax, &k0, &k1);
+        if(k0 >= k1) continue;
+
+        // from here on every position is inside the sprite, but a sprite 32768
+        // or more pixels across, or a large step, still needs all 64 bits
+        int64_t su = u + du * k0, sv = v + dv * k0;
+        uint32_t* dst = target->pixels + y * target->stride + x0;
+
+        for(int32_t n = k0; n < k1; n += 256)
         {
-            fy = fys;
-            for (int32_t j = 0; j < h; j++, fy += fym)
-                Draw(x + i, y + j, olc_Sprite_GetPixel(sprite, fx + ox, fy + oy));
+            int32_t chunk = (k1 - n < 256) ? k1 - n : 256;
+
+            if(filter & olc_SPRITEFILTER_BILINEAR)
+            {
+                for(int32_t i = 0; i < chunk; i++, su += du, sv += dv)
+                {
+                    // taps either side of the pixel centre, clamped to the edges
+                    int64_t bu = su - 32768, bv = sv - 32768;
+                    int32_t ax = (int32_t)(bu >> 16), ay = (int32_t)(bv >> 16);
+                    int32_t bx = ax + 1, by = ay + 1;
+                    if(ax < 0) ax = 0;
+                    if(ay < 0) ay = 0;
+                    if(bx >= sprite->width) bx = sprite->width - 1;
+                    if(by >= sprite->height) by = sprite->height - 1;
+
+                    const uint32_t* ra = sprite->pixels + ay * sprite->stride;
+                    const uint32_t* rb = sprite->pixels + by * sprite->stride;
+                    uint32_t wx = (bu >> 8) & 0xFF, wy = (bv >> 8) & 0xFF;
+                    buffer[i] = lerp_px(lerp_px(ra[ax], ra[bx], wx), lerp_px(rb[ax], rb[bx], wx), wy);
+                }
+            }
+            else
+            {
+                for(int32_t i = 0; i < chunk; i++, su += du, sv += dv)
+                    buffer[i] = sprite->pixels[(sv >> 16) * sprite->stride + (su >> 16)];
+            }
+
+            blitspan(dst + n, buffer, chunk, x0 + n, y, sprite->bPremultiplied);
         }
     }
-
 }
 
 // Decal Quad functions
@@ -1177,7 +3295,11 @@ void DrawDecal(olc_vf2d pos, olc_Decal *decal, olc_vf2d scale, const olc_Pixel t
     vScreenSpaceDim.x = vScreenSpacePos.x + (2.0f * ((float)(decal->sprite->width) * PGE.vInvScreenSize.x)) * scale.x;
     vScreenSpaceDim.y = vScreenSpacePos.y - (2.0f * ((float)(decal->sprite->height) * PGE.vInvScreenSize.y)) * scale.y;
 
-    olc_DecalInstance* di = olc_DecalInstance_Create();
+    olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, PGE.nTargetLayer);
+    if(ld == NULL)
+        return;
+
+    olc_DecalInstance* di = olc_DecalInstanceArena_Push(&ld->vecDecalInstance);
     
     di->decal = decal;
     
@@ -1187,11 +3309,6 @@ void DrawDecal(olc_vf2d pos, olc_Decal *decal, olc_vf2d scale, const olc_Pixel t
     di->pos[1] = olc_VF2D( vScreenSpacePos.x, vScreenSpaceDim.y );
     di->pos[2] = olc_VF2D( vScreenSpaceDim.x, vScreenSpaceDim.y );
     di->pos[3] = olc_VF2D( vScreenSpaceDim.x, vScreenSpacePos.y );
-
-    olc_LayerDesc* ld = vector_get(&PGE.vLayers, PGE.nTargetLayer);
-    if(ld != NULL)
-        vector_push(&ld->vecDecalInstance, di);
-    
 }
 
 // Draws a region of a decal, with optional scale and tinting
@@ -1207,7 +3324,11 @@ void DrawPartialDecal(olc_vf2d pos, olc_Decal* decal, olc_vf2d source_pos, olc_v
         vScreenSpacePos.y - (2.0f * source_size.y * PGE.vInvScreenSize.y) * scale.y
     );
 
-    olc_DecalInstance* di = olc_DecalInstance_Create();
+    olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, PGE.nTargetLayer);
+    if(ld == NULL)
+        return;
+
+    olc_DecalInstance* di = olc_DecalInstanceArena_Push(&ld->vecDecalInstance);
 
     di->decal = decal; di->tint[0] = tint;
 
@@ -1221,10 +3342,6 @@ void DrawPartialDecal(olc_vf2d pos, olc_Decal* decal, olc_vf2d source_pos, olc_v
     
     di->uv[0] = olc_VF2D( uvtl.x, uvtl.y ); di->uv[1] = olc_VF2D( uvtl.x, uvbr.y );
     di->uv[2] = olc_VF2D( uvbr.x, uvbr.y ); di->uv[3] = olc_VF2D( uvbr.x, uvtl.y );	
-
-    olc_LayerDesc* ld = vector_get(&PGE.vLayers, PGE.nTargetLayer);
-    if(ld != NULL)
-        vector_push(&ld->vecDecalInstance, di);
 }
 
 // Draws fully user controlled 4 vertices, pos(pixels), uv(pixels), colours
@@ -1248,7 +3365,11 @@ void DrawPartialWarpedDecal(olc_Decal* decal, olc_vf2d pos[4], olc_vf2d source_p
 // Draws a decal rotated to specified angle, wit point of rotation offset
 void DrawRotatedDecal(olc_vf2d pos, olc_Decal* decal, const float fAngle, olc_vf2d center, olc_vf2d scale, const olc_Pixel tint)
 {
-    olc_DecalInstance* di = olc_DecalInstance_Create();
+    olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, PGE.nTargetLayer);
+    if(ld == NULL)
+        return;
+
+    olc_DecalInstance* di = olc_DecalInstanceArena_Push(&ld->vecDecalInstance);
 
     di->decal = decal; di->tint[0] = tint;
 
@@ -1265,15 +3386,15 @@ void DrawRotatedDecal(olc_vf2d pos, olc_Decal* decal, const float fAngle, olc_vf
         di->pos[i] = olc_VF2D(di->pos[i].x * PGE.vInvScreenSize.x * 2.0f - 1.0f, di->pos[i].y * PGE.vInvScreenSize.y * 2.0f - 1.0f);
         di->pos[i].y *= -1.0f;
     }
-
-    olc_LayerDesc* ld = vector_get(&PGE.vLayers, PGE.nTargetLayer);
-    if(ld != NULL)
-        vector_push(&ld->vecDecalInstance, di);
 }
 
 void DrawPartialRotatedDecal(olc_vf2d pos, olc_Decal* decal, const float fAngle, olc_vf2d center, olc_vf2d source_pos, olc_vf2d source_size, olc_vf2d scale, const olc_Pixel tint)
 {
-    olc_DecalInstance* di = olc_DecalInstance_Create();
+    olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, PGE.nTargetLayer);
+    if(ld == NULL)
+        return;
+
+    olc_DecalInstance* di = olc_DecalInstanceArena_Push(&ld->vecDecalInstance);
 
     di->decal = decal; di->tint[0] = tint;
 
@@ -1295,10 +3416,6 @@ void DrawPartialRotatedDecal(olc_vf2d pos, olc_Decal* decal, const float fAngle,
     
     di->uv[0] = olc_VF2D( uvtl.x, uvtl.y ); di->uv[1] = olc_VF2D( uvtl.x, uvbr.y );
     di->uv[2] = olc_VF2D( uvbr.x, uvbr.y ); di->uv[3] = olc_VF2D( uvbr.x, uvtl.y );	
-
-    olc_LayerDesc* ld = vector_get(&PGE.vLayers, PGE.nTargetLayer);
-    if(ld != NULL)
-        vector_push(&ld->vecDecalInstance, di);
 }
 
 // Draws a multiline string as a decal, with tiniting and scaling
@@ -1378,9 +3495,7 @@ void DrawString(int32_t x, int32_t y, const char* sText, olc_Pixel col, uint32_t
                 for (uint32_t i = 0; i < 8; i++)
                     for (uint32_t j = 0; j < 8; j++)
                         if(olc_Sprite_GetPixel(PGE.fontSprite,i + ox * 8, j + oy * 8).r > 0)
-                            for (uint32_t is = 0; is < scale; is++)
-                                for (uint32_t js = 0; js < scale; js++)
-                                    Draw(x + sx + (i*scale) + is, y + sy + (j*scale) + js, col);
+                            FillRect(x + sx + (i*scale), y + sy + (j*scale), scale, scale, col);
             }
             else
             {
@@ -1417,18 +3532,38 @@ olc_vi2d GetTextSize(const char* s)
 // Clears entire draw target to Pixel
 void Clear(olc_Pixel p)
 {
-    int pixels = GetDrawTargetWidth() * GetDrawTargetHeight();
-    uint32_t* m = olc_Sprite_GetData(GetDrawTarget());
-    for(int i = 0; i < pixels; i++) m[i] = p.n;    
+    olc_Sprite* target = GetDrawTarget();
+    uint32_t* m = olc_Sprite_GetData(target);
+
+    // an owning sprite has its row padding cleared too, so it is one contiguous
+    // run; a view must leave the rest of its parent untouched
+    int rows = (target->parent == NULL) ? 1 : target->height;
+    int pixels = (target->parent == NULL) ? target->stride * target->height : target->width;
+
+    if(target->bPremultiplied)
+        p.n = premultiply_px(p.n);
+
+    for(int y = 0; y < rows; y++, m += target->stride)
+        olc_Span.fill(m, p.n, pixels);
+
+    // and its depth goes back to the furthest there is, which is every bit set
+    olc_Sprite* root = olc_Sprite_GetRoot(target);
+    if(root->depth != NULL)
+    {
+        size_t bytes = root->nDepthBits / 8;
+        uint8_t* d = (uint8_t*)root->depth + (size_t)(target->pixels - root->pixels) * bytes;
+        for(int y = 0; y < rows; y++, d += (size_t)target->stride * bytes)
+            memset(d, 0xFF, (size_t)pixels * bytes);
+    }
 }
 
 // CONFIGURATION ROUTINES
 void SetAppName(const char* title)
 {
     if(PGE.sAppName != NULL)
-        free(PGE.sAppName);
+        olc_Free(PGE.sAppName);
     
-    PGE.sAppName = (char*)calloc(sizeof(char),strlen(title)+1);
+    PGE.sAppName = (char*)olc_Calloc(sizeof(char), strlen(title)+1, olc_ALLOC_GENERAL);
     
     if(PGE.sAppName == NULL)
     {
@@ -1443,8 +3578,9 @@ void SetAppName(const char* title)
 // Layer targeting functions
 void SetLayerDrawTarget(uint8_t layer)
 {
-    olc_LayerDesc* ld = (olc_LayerDesc*)vector_get(&PGE.vLayers, layer);
+    olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, layer);
     PGE.pDrawTarget = ld->pDrawTarget;
+    olc_Sprite_Invalidate(PGE.pDrawTarget);
     ld->bUpdate = true;
     PGE.nTargetLayer = layer;
 }
@@ -1453,7 +3589,7 @@ void EnableLayer(uint8_t layer, bool b)
 {
     if(layer < PGE.vLayers.size)
     {
-        olc_LayerDesc* ld = (olc_LayerDesc*)vector_get(&PGE.vLayers, layer);
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, layer);
         ld->bShow = b;
     }
 }
@@ -1462,7 +3598,7 @@ void SetLayerOffset(uint8_t layer, float x, float y)
 {
     if(layer < PGE.vLayers.size)
     {
-        olc_LayerDesc* ld = (olc_LayerDesc*)vector_get(&PGE.vLayers, layer);
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, layer);
         ld->vOffset.x = x;
         ld->vOffset.y = y;
     }
@@ -1473,7 +3609,7 @@ void SetLayerScale(uint8_t layer, float x, float y)
 {
     if(layer < PGE.vLayers.size)
     {
-        olc_LayerDesc* ld = (olc_LayerDesc*)vector_get(&PGE.vLayers, layer);
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, layer);
         ld->vScale.x = x;
         ld->vScale.y = y;
     }
@@ -1483,7 +3619,7 @@ void SetLayerTint(uint8_t layer, const olc_Pixel tint)
 {
     if(layer < PGE.vLayers.size)
     {
-        olc_LayerDesc* ld = (olc_LayerDesc*)vector_get(&PGE.vLayers, layer);
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, layer);
         ld->tint = tint;
     }
 }
@@ -1492,29 +3628,51 @@ void SetLayerCustomRenderFunction(uint8_t layer, void (*f)())
 {
     if(layer < PGE.vLayers.size)
     {
-        olc_LayerDesc* ld = vector_get(&PGE.vLayers, layer);
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, layer);
         ld->funcHook = f;
     }
 }
 
-vector GetLayers()
+// Returns the highest number of decal instances submitted to a layer in one frame
+size_t GetLayerDecalInstancePeak(uint8_t layer)
+{
+    if(layer < PGE.vLayers.size)
+    {
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, layer);
+        return ld->vecDecalInstance.peak;
+    }
+
+    return 0;
+}
+
+olc_vector_olc_LayerDescPtr GetLayers()
 { return PGE.vLayers; }
 
 uint32_t CreateLayer()
 {
-    olc_LayerDesc* ld = (olc_LayerDesc*)malloc(sizeof(olc_LayerDesc));
-    
+    olc_LayerDesc* ld = (olc_LayerDesc*)olc_Malloc(sizeof(olc_LayerDesc), olc_ALLOC_GENERAL);
+    if(ld == NULL)
+    {
+        fprintf(stderr, "Failed to allocate ram for layer.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ld->vOffset = olc_VF2D(0.0f, 0.0f);
+    ld->vScale = olc_VF2D(1.0f, 1.0f);
+    ld->bShow = false;
+    ld->bUpdate = false;
     ld->pDrawTarget = olc_Sprite_Create(PGE.vScreenSize.x, PGE.vScreenSize.y);
     ld->nResID = olc_Renderer_CreateTexture(PGE.vScreenSize.x, PGE.vScreenSize.y);
     ld->tint = olc_WHITE;
     ld->funcHook = NULL;
 
-    vector_init(&ld->vecDecalInstance);
+    ld->pDrawTarget->bPremultiplied = PGE.bPremultipliedAlpha;
+    olc_Renderer_SetTexturePremultiplied(ld->nResID, PGE.bPremultipliedAlpha);
+
+    olc_DecalInstanceArena_Init(&ld->vecDecalInstance);
     olc_Renderer_UpdateTexture(ld->nResID, ld->pDrawTarget);
     
-    vector_push(&PGE.vLayers, ld);
-    
-    return (uint32_t)(PGE.vLayers.size - 1);
+    return (uint32_t)olc_vector_olc_LayerDescPtr_push(&PGE.vLayers, ld);
 }
 
 // Change the pixel mode for different optimisations
@@ -1534,12 +3692,55 @@ void SetCustomPixelMode(olc_Pixel (*f)(int x, int y, olc_Pixel p1, olc_Pixel p2)
     PGE.nPixelMode = olc_PIXELMODE_CUSTOM;
 }
 
+// Use a custom blend function that works on a whole run of pixels at a time
+void SetCustomSpanPixelMode(void (*f)(int x, int y, const olc_Pixel* src, olc_Pixel* dst, int count))
+{
+    PGE.funcSpanMode = f;
+    PGE.nPixelMode = olc_PIXELMODE_CUSTOM_SPAN;
+}
+
 // Change the blend factor form between 0.0f to 1.0f;
 void SetPixelBlend(float fBlend)
 {
-    PGE.fFrameTimer = fBlend;
+    PGE.fBlendFactor = fBlend;
     if(PGE.fBlendFactor < 0.0f) PGE.fBlendFactor = 0.0f;
     if(PGE.fBlendFactor > 1.0f) PGE.fBlendFactor = 1.0f;
+    PGE.nBlendFactor = (uint32_t)(PGE.fBlendFactor * 256.0f + 0.5f);
+}
+
+// Store sprites loaded from now on, and every layer, with premultiplied alpha
+void SetPremultipliedAlpha(bool bPremultiplied)
+{
+    PGE.bPremultipliedAlpha = bPremultiplied;
+
+    // bring the existing layers over, keeping what is already drawn on them
+    for(size_t i = 0; i < PGE.vLayers.size; i++)
+    {
+        olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, i);
+        if(bPremultiplied) olc_Sprite_Premultiply(ld->pDrawTarget);
+        else               olc_Sprite_Unpremultiply(ld->pDrawTarget);
+        olc_Renderer_SetTexturePremultiplied(ld->nResID, bPremultiplied);
+        ld->bUpdate = true;
+    }
+}
+
+// Are sprites and layers being stored with premultiplied alpha?
+bool IsPremultipliedAlpha()
+{ return PGE.bPremultipliedAlpha; }
+
+// Draw only what is no further away than the draw target's depth plane holds
+void SetDepthTest(bool bTest)
+{ PGE.bDepthTest = bTest; }
+
+// Record the depth of what is drawn in the draw target's depth plane
+void SetDepthWrite(bool bWrite)
+{ PGE.bDepthWrite = bWrite; }
+
+// Depth of everything drawn from now on, 0 nearest to 1 furthest
+void SetDrawDepth(float fDepth)
+{
+    fDepth = (fDepth < 0.0f) ? 0.0f : (fDepth > 1.0f) ? 1.0f : fDepth;
+    PGE.nDrawDepth = (uint32_t)(fDepth * 4294967295.0 + 0.5);
 }
 
 // Offset texels by sub-pixel amount (advanced, do not use)
@@ -1628,7 +3829,7 @@ void olc_PGE_ConstructFontSheet()
     "O`000P08Od400g`<3V=P0G`673IP0`@3>1`00P@6O`P00g`<O`000GP800000000"
     "?P9PL020O`<`N3R0@E4HC7b0@ET<ATB0@@l6C4B0O`H3N7b0?P01L3R000000020";
 
-    PGE.fontSprite = olc_Sprite_Create(128, 48);
+    PGE.fontSprite = olc_Sprite_CreateUninitialised(128, 48);
     int px = 0, py = 0;
     for (size_t b = 0; b < 1024; b += 4)
     {
@@ -1657,6 +3858,10 @@ void olc_PGE_DestroyFontSheet()
 
 void olc_PGE_CoreUpdate()
 {
+    // anything allocated from here on is counted against this frame
+    nFrameAllocations = 0;
+    bAllocInFrame = true;
+
     PGE.tp2 = SDL_GetPerformanceCounter();
     double duration = (double)((PGE.tp2 - PGE.tp1)*1000) / SDL_GetPerformanceFrequency();
     PGE.tp1 = PGE.tp2;
@@ -1729,7 +3934,7 @@ void olc_PGE_CoreUpdate()
     olc_Renderer_ClearBuffer(olc_BLACK, true);
 
     // Layer 0
-    olc_LayerDesc* ld = vector_get(&PGE.vLayers, 0);
+    olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, 0);
     ld->bUpdate = true;
     ld->bShow = true;
 
@@ -1737,7 +3942,7 @@ void olc_PGE_CoreUpdate()
 
     for(int i = PGE.vLayers.size-1; i >= 0; i--)
     {
-        olc_LayerDesc* layer = vector_get(&PGE.vLayers, i);
+        olc_LayerDesc* layer = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, i);
         if(layer->bShow)
         {
             if(layer->funcHook == NULL)
@@ -1752,14 +3957,11 @@ void olc_PGE_CoreUpdate()
                 olc_Renderer_DrawLayerQuad(layer->vOffset, layer->vScale, layer->tint);
 
                 // Display Decals in order for this layer
-                for(int j = 0; j < layer->vecDecalInstance.size; j++)
-                {
-                    olc_DecalInstance* decal = vector_get(&layer->vecDecalInstance, j);
-                    olc_Renderer_DrawDecalQuad(decal);
-                }
+                for(size_t j = 0; j < layer->vecDecalInstance.instances.size; j++)
+                    olc_Renderer_DrawDecalQuad(&layer->vecDecalInstance.instances.items[j]);
 
-                // clear the instances
-                vector_clear(&layer->vecDecalInstance);
+                // clear the instances, the arena keeps its memory for the next frame
+                olc_DecalInstanceArena_Reset(&layer->vecDecalInstance);
             }
             else
             {
@@ -1785,6 +3987,9 @@ void olc_PGE_CoreUpdate()
         olc_Platform_SetWindowTitle(PGE.sTitle);
         PGE.nFrameCount = 0;
     }
+
+    bAllocInFrame = false;
+    nLastFrameAllocations = nFrameAllocations;
 }
 
 void olc_PGE_PrepareEngine()
@@ -1793,12 +3998,12 @@ void olc_PGE_PrepareEngine()
     if(olc_Platform_CreateGraphics(PGE.bFullScreen, PGE.bEnableVSYNC, PGE.vViewPos, PGE.vViewSize) == olc_RCODE_FAIL) return;
 
     // Initialize Layer Vector
-    vector_init(&PGE.vLayers);
+    olc_vector_olc_LayerDescPtr_init(&PGE.vLayers);
     
     // Create Primary Layer "0"
     CreateLayer();
 
-    olc_LayerDesc* ld = vector_get(&PGE.vLayers, 0);
+    olc_LayerDesc* ld = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, 0);
     ld->bUpdate = true;
     ld->bShow = true;
     SetDrawTarget(NULL);
@@ -1828,70 +4033,83 @@ void olc_PGE_Terminate()
 
 // RENDERER
 
-void texturemap_init(vector* v)
+void texturemap_init(texturemap* m)
 {
-    vector_init(v);
+    olc_vector_texturedata_init(&m->slots);
+    m->freeHead = olc_TEXTURE_NO_SLOT;
 }
 
-void texturemap_destroy(vector* v)
+void texturemap_destroy(texturemap* m)
 {
-    vector_free(v);
+    // destroy any textures still alive
+    for(size_t i = 0; i < m->slots.size; i++)
+    {
+        if(m->slots.items[i].t != NULL)
+            SDL_DestroyTexture(m->slots.items[i].t);
+    }
+
+    olc_vector_texturedata_free(&m->slots);
+    texturemap_init(m);
 }
 
-void texturemap_delete(vector* v, int id)
+// resolve a handle to its slot, NULL if the handle is out of range, stale or free
+static texturedata* texturemap_slot(texturemap* m, uint32_t id)
 {
-    for(int i = 0; i < v->size; i++)
-    {
-        texturedata* temp = (texturedata*)vector_get(v, i);
-        if(id == temp->id)
-        {
-            SDL_DestroyTexture(temp->t);
-            temp->t = NULL;
-            vector_remove(v, i);
-            return;
-        }
-    }
+    texturedata* slot = olc_vector_texturedata_get(&m->slots, id & olc_TEXTURE_INDEX_MASK);
+    if(slot == NULL || slot->t == NULL || slot->generation != (id >> olc_TEXTURE_INDEX_BITS)) return NULL;
+
+    return slot;
 }
 
-SDL_Texture* texturemap_get(vector* v, int id)
+void texturemap_delete(texturemap* m, uint32_t id)
 {
-    for(int i = 0; i < v->size; i++)
-    {
-        texturedata* temp = (texturedata*)vector_get(v, i);
-        if(id == temp->id)
-            return temp->t;
-    }
-   
-    return 0;
+    texturedata* slot = texturemap_slot(m, id);
+    if(slot == NULL) return;
+
+    SDL_DestroyTexture(slot->t);
+    slot->t = NULL;
+
+    // invalidate outstanding handles and put the slot on the free list
+    slot->generation = (slot->generation + 1) & olc_TEXTURE_GENERATION_MASK;
+    slot->nextFree = m->freeHead;
+    m->freeHead = id & olc_TEXTURE_INDEX_MASK;
+}
+
+SDL_Texture* texturemap_get(texturemap* m, uint32_t id)
+{
+    texturedata* slot = texturemap_slot(m, id);
+    return (slot != NULL) ? slot->t : NULL;
 }
 
-void texturemap_set(vector* v, int id, SDL_Texture* texture)
+uint32_t texturemap_insert(texturemap* m, SDL_Texture* texture)
 {
-    // check if key already exists
-    for(int i = 0; i < v->size; i++)
+    uint32_t index;
+    texturedata* slot;
+
+    if(m->freeHead != olc_TEXTURE_NO_SLOT)
+    {
+        // reuse the most recently freed slot
+        index = m->freeHead;
+        slot = &m->slots.items[index];
+        m->freeHead = slot->nextFree;
+    }
+    else
     {
-        texturedata* temp = (texturedata*)vector_get(v, i);
-        if(id == temp->id)
+        if(m->slots.size > olc_TEXTURE_INDEX_MASK)
         {
-            temp->t = texture;
-            return;
+            fprintf(stderr, "Too many textures.\n");
+            exit(EXIT_FAILURE);
         }
-    }
 
-    // if we made it here, we have to create a new inputdata
-    texturedata* temp = (texturedata*)malloc(sizeof(texturedata));
-    if(temp == NULL)
-    {
-        fprintf(stderr, "Failed to allocate memory.\n");
-        exit(EXIT_FAILURE);
+        index = (uint32_t)m->slots.size;
+        slot = olc_vector_texturedata_emplace(&m->slots);
+        slot->generation = 0;
     }
-    
-    // set data
-    temp->id = id;
-    temp->t = texture;
 
-    // push into vector
-    vector_push(v, temp);
+    slot->nextFree = olc_TEXTURE_NO_SLOT;
+    slot->t = texture;
+
+    return (slot->generation << olc_TEXTURE_INDEX_BITS) | index;
 }
 
 void olc_Renderer_PrepareDevice()
@@ -1900,15 +4118,14 @@ void olc_Renderer_PrepareDevice()
 int32_t olc_Renderer_CreateDevice(bool bFullScreen, bool bVSYNC)
 {
     texturemap_init(&mapTextures);
+    modePremultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
     return olc_RCODE_OK;
 }
 
 int32_t olc_Renderer_DestroyDevice()
 {
-    for(int i = 0; i < mapTextures.size; i++)
-    {
-        texturemap_delete(&mapTextures, i);
-    }
     texturemap_destroy(&mapTextures);
     return olc_RCODE_OK;
 }
@@ -1921,13 +4138,27 @@ void olc_Renderer_DisplayFrame()
 void olc_Renderer_PrepareDrawing()
 {}
 
+// Locally used function to tint a texture. The colour of a premultiplied
+// texture is not scaled by its alpha when blended, so the tint's alpha
+// has to be folded into its colour as well
+void ApplyTint(SDL_Texture* texture, olc_Pixel tint)
+{
+    SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+    SDL_GetTextureBlendMode(texture, &mode);
+
+    if(mode == modePremultiplied)
+        SDL_SetTextureColorMod(texture, olc_MUL255(tint.r, tint.a), olc_MUL255(tint.g, tint.a), olc_MUL255(tint.b, tint.a));
+    else
+        SDL_SetTextureColorMod(texture, tint.r, tint.g, tint.b);
+    SDL_SetTextureAlphaMod(texture, tint.a);
+}
+
 void olc_Renderer_DrawLayerQuad(olc_vf2d offset, olc_vf2d scale, const olc_Pixel tint)
 {
     SDL_Texture* texture = texturemap_get(&mapTextures, nActiveTexture);
 
     // Apply Tint
-    SDL_SetTextureColorMod(texture, tint.r, tint.g, tint.b);
-    SDL_SetTextureAlphaMod(texture, tint.a);
+    ApplyTint(texture, tint);
 
     // Draw Texture
     SDL_RenderCopy(olc_Renderer, texture, NULL, NULL);
@@ -2021,8 +4252,7 @@ void olc_Renderer_DrawDecalQuad(olc_DecalInstance* decal)
     SDL_Point center; center.x = 0; center.y = 0;
 
     // Apply Tint
-    SDL_SetTextureColorMod(texture, decal->tint[0].r, decal->tint[0].g, decal->tint[0].b);
-    SDL_SetTextureAlphaMod(texture, decal->tint[0].a);
+    ApplyTint(texture, decal->tint[0]);
     
     // Draw Texture
     SDL_RenderCopyEx(olc_Renderer, texture, &src, &dest, fAngle, &center, SDL_FLIP_NONE);
@@ -2030,7 +4260,6 @@ void olc_Renderer_DrawDecalQuad(olc_DecalInstance* decal)
 
 uint32_t olc_Renderer_CreateTexture(const uint32_t width, const uint32_t height)
 {
-    int id = nTextureID++;
     SDL_Texture* texture = SDL_CreateTexture(olc_Renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, width, height);
     if(texture == NULL)
     {
@@ -2038,15 +4267,20 @@ uint32_t olc_Renderer_CreateTexture(const uint32_t width, const uint32_t height)
         exit(EXIT_FAILURE);
     }
     SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-    texturemap_set(&mapTextures, id, texture);
+    return texturemap_insert(&mapTextures, texture);
+}
 
-    return id;
+void olc_Renderer_SetTexturePremultiplied(uint32_t id, bool bPremultiplied)
+{
+    SDL_Texture* texture = texturemap_get(&mapTextures, id);
+    if(texture != NULL)
+        SDL_SetTextureBlendMode(texture, bPremultiplied ? modePremultiplied : SDL_BLENDMODE_BLEND);
 }
 
 void olc_Renderer_UpdateTexture(uint32_t id, olc_Sprite* spr)
 {
     SDL_Texture* texture = texturemap_get(&mapTextures, id);
-    SDL_UpdateTexture(texture, NULL, (void*)olc_Sprite_GetData(spr), spr->width * 4);
+    SDL_UpdateTexture(texture, NULL, (void*)olc_Sprite_GetData(spr), spr->stride * sizeof(uint32_t));
 }
 
 uint32_t olc_Renderer_DeleteTexture(const uint32_t id)
@@ -2078,68 +4312,77 @@ void olc_Renderer_ClearBuffer(olc_Pixel p, bool bDepth)
 // PLATFORM
 
 
-void inputmap_init(vector* v)
-{
-    vector_init(v);
-}
-
-void inputmap_destroy(vector* v)
-{
-    vector_free(v);
-}
-
-void inputmap_delete(vector* v, size_t key)
-{
-    for(int i = 0; i < v->size; i++)
-    {
-        inputdata* temp = (inputdata*)vector_get(v, i);
-        if(key == temp->key)
-        {
-            vector_remove(v, i);
-            return;
-        }
-    }
-}
+// Keycode to olc_Key translation, resolved entirely at compile time
+#define olc_KEYCHAR(k) [k]
+#define olc_KEYCODE(k) [olc_nKeyMapChars + ((k) & ~SDLK_SCANCODE_MASK)]
 
-uint8_t inputmap_get(vector* v, size_t key)
+static const uint8_t mapKeys[olc_nKeyMapSize] =
 {
-    for(int i = 0; i < v->size; i++)
-    {
-        inputdata* temp = (inputdata*)vector_get(v, i);
-        if(key == temp->key)
-            return temp->val;
-    }
-   
-    return 0;
-}
-
-void inputmap_set(vector* v, size_t key, uint8_t val)
+    olc_KEYCHAR(SDLK_UNKNOWN) = olc_NONE,
+    olc_KEYCHAR(SDLK_a) = olc_A, olc_KEYCHAR(SDLK_b) = olc_B,
+    olc_KEYCHAR(SDLK_c) = olc_C, olc_KEYCHAR(SDLK_d) = olc_D,
+    olc_KEYCHAR(SDLK_e) = olc_E, olc_KEYCHAR(SDLK_f) = olc_F,
+    olc_KEYCHAR(SDLK_g) = olc_G, olc_KEYCHAR(SDLK_h) = olc_H,
+    olc_KEYCHAR(SDLK_i) = olc_I, olc_KEYCHAR(SDLK_j) = olc_J,
+    olc_KEYCHAR(SDLK_k) = olc_K, olc_KEYCHAR(SDLK_l) = olc_L,
+    olc_KEYCHAR(SDLK_m) = olc_M, olc_KEYCHAR(SDLK_n) = olc_N,
+    olc_KEYCHAR(SDLK_o) = olc_O, olc_KEYCHAR(SDLK_p) = olc_P,
+    olc_KEYCHAR(SDLK_q) = olc_Q, olc_KEYCHAR(SDLK_r) = olc_R,
+    olc_KEYCHAR(SDLK_s) = olc_S, olc_KEYCHAR(SDLK_t) = olc_T,
+    olc_KEYCHAR(SDLK_u) = olc_U, olc_KEYCHAR(SDLK_v) = olc_V,
+    olc_KEYCHAR(SDLK_w) = olc_W, olc_KEYCHAR(SDLK_x) = olc_X,
+    olc_KEYCHAR(SDLK_y) = olc_Y, olc_KEYCHAR(SDLK_z) = olc_Z,
+
+    olc_KEYCHAR(SDLK_0) = olc_K0, olc_KEYCHAR(SDLK_1) = olc_K1,
+    olc_KEYCHAR(SDLK_2) = olc_K2, olc_KEYCHAR(SDLK_3) = olc_K3,
+    olc_KEYCHAR(SDLK_4) = olc_K4, olc_KEYCHAR(SDLK_5) = olc_K5,
+    olc_KEYCHAR(SDLK_6) = olc_K6, olc_KEYCHAR(SDLK_7) = olc_K7,
+    olc_KEYCHAR(SDLK_8) = olc_K8, olc_KEYCHAR(SDLK_9) = olc_K9,
+
+    olc_KEYCODE(SDLK_F1)  = olc_F1,  olc_KEYCODE(SDLK_F2)  = olc_F2,
+    olc_KEYCODE(SDLK_F3)  = olc_F3,  olc_KEYCODE(SDLK_F4)  = olc_F4,
+    olc_KEYCODE(SDLK_F5)  = olc_F5,  olc_KEYCODE(SDLK_F6)  = olc_F6,
+    olc_KEYCODE(SDLK_F7)  = olc_F7,  olc_KEYCODE(SDLK_F8)  = olc_F8,
+    olc_KEYCODE(SDLK_F9)  = olc_F9,  olc_KEYCODE(SDLK_F10) = olc_F10,
+    olc_KEYCODE(SDLK_F11) = olc_F11, olc_KEYCODE(SDLK_F12) = olc_F12,
+
+    olc_KEYCODE(SDLK_DOWN)       = olc_DOWN,   olc_KEYCODE(SDLK_LEFT)     = olc_LEFT,
+    olc_KEYCODE(SDLK_RIGHT)      = olc_RIGHT,  olc_KEYCODE(SDLK_UP)       = olc_UP,
+    olc_KEYCODE(SDLK_KP_ENTER)   = olc_ENTER,  olc_KEYCHAR(SDLK_RETURN)   = olc_ENTER,
+    olc_KEYCHAR(SDLK_BACKSPACE)  = olc_BACK,   olc_KEYCHAR(SDLK_ESCAPE)   = olc_ESCAPE,
+    olc_KEYCODE(SDLK_PAUSE)      = olc_PAUSE,  olc_KEYCODE(SDLK_SCROLLLOCK) = olc_SCROLL,
+    olc_KEYCHAR(SDLK_TAB)        = olc_TAB,    olc_KEYCHAR(SDLK_DELETE)   = olc_DEL,
+    olc_KEYCODE(SDLK_HOME)       = olc_HOME,   olc_KEYCODE(SDLK_END)      = olc_END,
+    olc_KEYCODE(SDLK_PAGEUP)     = olc_PGUP,   olc_KEYCODE(SDLK_PAGEDOWN) = olc_PGDN,
+    olc_KEYCODE(SDLK_INSERT)     = olc_INS,    olc_KEYCHAR(SDLK_SPACE)    = olc_SPACE,
+    olc_KEYCODE(SDLK_LSHIFT)     = olc_SHIFT,  olc_KEYCODE(SDLK_RSHIFT)   = olc_SHIFT,
+    olc_KEYCODE(SDLK_LCTRL)      = olc_CTRL,   olc_KEYCODE(SDLK_RCTRL)    = olc_CTRL,
+
+    olc_KEYCODE(SDLK_KP_0) = olc_NP0, olc_KEYCODE(SDLK_KP_1) = olc_NP1,
+    olc_KEYCODE(SDLK_KP_2) = olc_NP2, olc_KEYCODE(SDLK_KP_3) = olc_NP3,
+    olc_KEYCODE(SDLK_KP_4) = olc_NP4, olc_KEYCODE(SDLK_KP_5) = olc_NP5,
+    olc_KEYCODE(SDLK_KP_6) = olc_NP6, olc_KEYCODE(SDLK_KP_7) = olc_NP7,
+    olc_KEYCODE(SDLK_KP_8) = olc_NP8, olc_KEYCODE(SDLK_KP_9) = olc_NP9,
+
+    olc_KEYCODE(SDLK_KP_MULTIPLY) = olc_NP_MUL,     olc_KEYCODE(SDLK_KP_DIVIDE) = olc_NP_DIV,
+    olc_KEYCODE(SDLK_KP_PLUS)     = olc_NP_ADD,     olc_KEYCODE(SDLK_KP_MINUS)  = olc_NP_SUB,
+    olc_KEYCODE(SDLK_KP_PERIOD)   = olc_NP_DECIMAL, olc_KEYCHAR(SDLK_PERIOD)    = olc_PERIOD
+};
+
+#undef olc_KEYCHAR
+#undef olc_KEYCODE
+
+// translate an SDL keycode to an olc_Key, olc_NONE if it is not mapped
+uint8_t inputmap_get(SDL_Keycode key)
 {
-    // check if key already exists
-    for(int i = 0; i < v->size; i++)
-    {
-        inputdata* temp = (inputdata*)vector_get(v, i);
-        if(key == temp->key)
-        {
-            temp->val = val;
-            return;
-        }
-    }
+    uint32_t k = (uint32_t)key;
 
-    // if we made it here, we have to create a new inputdata
-    inputdata* temp = (inputdata*)malloc(sizeof(inputdata));
-    if(temp == NULL)
-    {
-        fprintf(stderr, "Failed to allocate memory.\n");
-        exit(EXIT_FAILURE);
-    }
-    
-    // set data
-    temp->key = key;
-    temp->val = val;
+    if(k & SDLK_SCANCODE_MASK)
+        k = olc_nKeyMapChars + (k & ~SDLK_SCANCODE_MASK);
+    else if(k >= olc_nKeyMapChars)
+        return olc_NONE;
 
-    // push into vector
-    vector_push(v, temp);    
+    return (k < olc_nKeyMapSize) ? mapKeys[k] : olc_NONE;
 }
 
 int32_t olc_Platform_ApplicationStartUp()
@@ -2149,16 +4392,30 @@ int32_t olc_Platform_ApplicationCleanUp()
 {
     for(size_t i = 0; i < PGE.vLayers.size; i++)
     {
-        olc_LayerDesc* layer = (olc_LayerDesc*)vector_get(&PGE.vLayers, i);
-        vector_clear(&layer->vecDecalInstance);
+        olc_LayerDesc* layer = *olc_vector_olc_LayerDescPtr_get(&PGE.vLayers, i);
+        olc_DecalInstanceArena_Free(&layer->vecDecalInstance);
+        olc_Free(layer);
     }
-    vector_clear(&PGE.vLayers);
+    olc_vector_olc_LayerDescPtr_free(&PGE.vLayers);
 
     olc_PGE_DestroyFontSheet();
+    ellipse_freecache();
+    olc_Free(PGE.pMeshScratch);
+    PGE.pMeshScratch = NULL;
+    PGE.nMeshScratch = 0;
+    olc_Free(PGE.pPolygonEdges);
+    olc_Free(PGE.pPolygonActive);
+    PGE.pPolygonEdges = NULL;
+    PGE.pPolygonActive = NULL;
+    PGE.nPolygonScratch = 0;
+    olc_Free(PGE.pFloodSpans);
+    olc_Free(PGE.pFloodStamps);
+    PGE.pFloodSpans = NULL;
+    PGE.pFloodStamps = NULL;
+    PGE.nFloodSpanCapacity = 0;
+    PGE.nFloodStampSize = 0;
     olc_Sprite_Destroy(PGE.pDrawTarget);
-    free(PGE.sAppName);
-    
-    inputmap_destroy(&mapKeys);
+    olc_Free(PGE.sAppName);
     
     SDL_DestroyRenderer(olc_Renderer);
     SDL_DestroyWindow(olc_Window);
@@ -2200,59 +4457,6 @@ int32_t olc_Platform_CreateWindowPane(const olc_vi2d vWindowPos, olc_vi2d vWindo
     SDL_SetWindowResizable(olc_Window, SDL_TRUE);
     SDL_SetWindowFullscreen(olc_Window, (bFullScreen) ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0 );
 
-    inputmap_init(&mapKeys);
-    
-    inputmap_set(&mapKeys, SDLK_UNKNOWN, olc_NONE);
-    inputmap_set(&mapKeys, SDLK_a, olc_A); inputmap_set(&mapKeys, SDLK_b, olc_B);
-    inputmap_set(&mapKeys, SDLK_c, olc_C); inputmap_set(&mapKeys, SDLK_d, olc_D);
-    inputmap_set(&mapKeys, SDLK_e, olc_E); inputmap_set(&mapKeys, SDLK_f, olc_F);
-    inputmap_set(&mapKeys, SDLK_g, olc_G); inputmap_set(&mapKeys, SDLK_h, olc_H);
-    inputmap_set(&mapKeys, SDLK_i, olc_I); inputmap_set(&mapKeys, SDLK_j, olc_J);
-    inputmap_set(&mapKeys, SDLK_k, olc_K); inputmap_set(&mapKeys, SDLK_l, olc_L);
-    inputmap_set(&mapKeys, SDLK_m, olc_M); inputmap_set(&mapKeys, SDLK_n, olc_N);
-    inputmap_set(&mapKeys, SDLK_o, olc_O); inputmap_set(&mapKeys, SDLK_p, olc_P);
-    inputmap_set(&mapKeys, SDLK_q, olc_Q); inputmap_set(&mapKeys, SDLK_r, olc_R);
-    inputmap_set(&mapKeys, SDLK_s, olc_S); inputmap_set(&mapKeys, SDLK_t, olc_T);
-    inputmap_set(&mapKeys, SDLK_u, olc_U); inputmap_set(&mapKeys, SDLK_v, olc_V);
-    inputmap_set(&mapKeys, SDLK_w, olc_W); inputmap_set(&mapKeys, SDLK_x, olc_X);
-    inputmap_set(&mapKeys, SDLK_y, olc_Y); inputmap_set(&mapKeys, SDLK_z, olc_Z);
-    
-    inputmap_set(&mapKeys, SDLK_0, olc_K0); inputmap_set(&mapKeys, SDLK_1, olc_K1); 
-    inputmap_set(&mapKeys, SDLK_2, olc_K2); inputmap_set(&mapKeys, SDLK_3, olc_K3);
-    inputmap_set(&mapKeys, SDLK_4, olc_K4); inputmap_set(&mapKeys, SDLK_5, olc_K5); 
-    inputmap_set(&mapKeys, SDLK_6, olc_K6); inputmap_set(&mapKeys, SDLK_7, olc_K7);
-    inputmap_set(&mapKeys, SDLK_8, olc_K8); inputmap_set(&mapKeys, SDLK_9, olc_K9);
-
-    inputmap_set(&mapKeys, SDLK_F1,  olc_F1);  inputmap_set(&mapKeys, SDLK_F2,  olc_F2);
-    inputmap_set(&mapKeys, SDLK_F3,  olc_F3);  inputmap_set(&mapKeys, SDLK_F4,  olc_F4);
-    inputmap_set(&mapKeys, SDLK_F5,  olc_F5);  inputmap_set(&mapKeys, SDLK_F6,  olc_F6);
-    inputmap_set(&mapKeys, SDLK_F7,  olc_F7);  inputmap_set(&mapKeys, SDLK_F8,  olc_F8);
-    inputmap_set(&mapKeys, SDLK_F9,  olc_F9);  inputmap_set(&mapKeys, SDLK_F10, olc_F10);
-    inputmap_set(&mapKeys, SDLK_F11, olc_F11); inputmap_set(&mapKeys, SDLK_F12, olc_F12);
-
-    inputmap_set(&mapKeys, SDLK_DOWN,       olc_DOWN);   inputmap_set(&mapKeys, SDLK_LEFT,   olc_LEFT);
-    inputmap_set(&mapKeys, SDLK_RIGHT,      olc_RIGHT);  inputmap_set(&mapKeys, SDLK_UP,     olc_UP);
-    inputmap_set(&mapKeys, SDLK_KP_ENTER,   olc_ENTER);  inputmap_set(&mapKeys, SDLK_RETURN, olc_ENTER);
-    inputmap_set(&mapKeys, SDLK_BACKSPACE,  olc_BACK);   inputmap_set(&mapKeys, SDLK_ESCAPE, olc_ESCAPE);
-    inputmap_set(&mapKeys, SDLK_RETURN,     olc_ENTER);  inputmap_set(&mapKeys, SDLK_PAUSE,  olc_PAUSE);
-    inputmap_set(&mapKeys, SDLK_SCROLLLOCK, olc_SCROLL); inputmap_set(&mapKeys, SDLK_TAB,    olc_TAB);
-    inputmap_set(&mapKeys, SDLK_DELETE,     olc_DEL);    inputmap_set(&mapKeys, SDLK_HOME,   olc_HOME);
-    inputmap_set(&mapKeys, SDLK_END,        olc_END);    inputmap_set(&mapKeys, SDLK_PAGEUP, olc_PGUP);
-    inputmap_set(&mapKeys, SDLK_PAGEDOWN,   olc_PGDN);   inputmap_set(&mapKeys, SDLK_INSERT, olc_INS);
-    inputmap_set(&mapKeys, SDLK_LSHIFT,     olc_SHIFT);  inputmap_set(&mapKeys, SDLK_RSHIFT, olc_SHIFT);
-    inputmap_set(&mapKeys, SDLK_LCTRL,      olc_CTRL);   inputmap_set(&mapKeys, SDLK_RCTRL,  olc_CTRL);
-    inputmap_set(&mapKeys, SDLK_SPACE,      olc_SPACE);
-
-    inputmap_set(&mapKeys, SDLK_KP_0, olc_NP0); inputmap_set(&mapKeys, SDLK_KP_1, olc_NP1);
-    inputmap_set(&mapKeys, SDLK_KP_2, olc_NP2); inputmap_set(&mapKeys, SDLK_KP_3, olc_NP3);
-    inputmap_set(&mapKeys, SDLK_KP_4, olc_NP4); inputmap_set(&mapKeys, SDLK_KP_5, olc_NP5);
-    inputmap_set(&mapKeys, SDLK_KP_6, olc_NP6); inputmap_set(&mapKeys, SDLK_KP_7, olc_NP7);
-    inputmap_set(&mapKeys, SDLK_KP_8, olc_NP8); inputmap_set(&mapKeys, SDLK_KP_9, olc_NP9);
-
-    inputmap_set(&mapKeys, SDLK_KP_MULTIPLY, olc_NP_MUL); inputmap_set(&mapKeys, SDLK_KP_DIVIDE, olc_NP_DIV);
-    inputmap_set(&mapKeys, SDLK_KP_PLUS, olc_NP_ADD); inputmap_set(&mapKeys, SDLK_KP_MINUS, olc_NP_SUB);
-    inputmap_set(&mapKeys, SDLK_KP_PERIOD, olc_NP_DECIMAL); inputmap_set(&mapKeys, SDLK_PERIOD, olc_PERIOD);
-
     return olc_RCODE_OK;
 }
 
@@ -2294,11 +4498,11 @@ int32_t olc_Platform_HandleSystemEvent()
         }
         else if(event.type == SDL_KEYDOWN)
         {
-            olc_PGE_UpdateKeyState(inputmap_get(&mapKeys, event.key.keysym.sym), true);
+            olc_PGE_UpdateKeyState(inputmap_get(event.key.keysym.sym), true);
         }
         else if(event.type == SDL_KEYUP)
         {
-            olc_PGE_UpdateKeyState(inputmap_get(&mapKeys, event.key.keysym.sym), false);
+            olc_PGE_UpdateKeyState(inputmap_get(event.key.keysym.sym), false);
         }
         else if(event.type == SDL_MOUSEBUTTONDOWN)
         {
@@ -2354,23 +4558,27 @@ olc_Sprite* olc_Sprite_LoadFromFile(const char* filename)
 
     SDL_Surface* image = SDL_ConvertSurfaceFormat(temp, SDL_PIXELFORMAT_ABGR8888, 0);
 
-    uint32_t* pixels = (uint32_t*)image->pixels;
-
-    olc_Sprite* sprite = olc_Sprite_Create(image->w, image->h);
+    olc_Sprite* sprite = olc_Sprite_CreateUninitialised(image->w, image->h);
     
     for(int y = 0; y < image->h; y++)
     {
+        uint32_t* src = (uint32_t*)((uint8_t*)image->pixels + y * image->pitch);
+        uint32_t* dst = sprite->pixels + y * sprite->stride;
+
         for(int x = 0; x < image->w; x++)
         {
-            olc_Pixel p = olc_PixelRAW(pixels[y * image->w + x]);
+            olc_Pixel p = olc_PixelRAW(src[x]);
             
             // obey intent of the alpha channel
             if(p.a == 0)
                 p.n = 0;
+            else if(PGE.bPremultipliedAlpha)
+                p.n = premultiply_px(p.n);
 
-            olc_Sprite_SetPixel(sprite, x, y, p);
+            dst[x] = p.n;
         }
     }
+    sprite->bPremultiplied = PGE.bPremultipliedAlpha;
 
     SDL_FreeSurface(image);
     SDL_FreeSurface(temp);
@@ -8,12 +8,67 @@
 #include <assert.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
+// O------------------------------------------------------------------------------O
+// | Allocator - Every engine allocation, tagged by what it is used for           |
+// O------------------------------------------------------------------------------O
+enum olc_AllocCategory
+{
+    olc_ALLOC_GENERAL,
+    olc_ALLOC_SPRITE_PIXELS,
+    olc_ALLOC_DECAL_INSTANCES,
+    olc_ALLOC_CONTAINERS,
+    olc_ALLOC_TEXTURES,
+    olc_ALLOC_CATEGORIES
+};
+
+// A single function does all the work, in the manner of lua_Alloc: with
+// newSize 0 it must free p and return NULL, otherwise it behaves like realloc
+// (p is NULL for fresh allocations). oldSize is the size p was allocated with.
+typedef struct Allocator
+{
+    void* (*funcAlloc)(void* user, void* p, size_t oldSize, size_t newSize, uint32_t category);
+    void* user;
+} olc_Allocator;
+
+typedef struct AllocStats
+{
+    size_t nBytes;            // bytes currently allocated
+    size_t nPeakBytes;        // highest value nBytes has reached
+    size_t nAllocations;      // allocations currently alive
+    size_t nTotalAllocations; // allocations and reallocations ever made
+} olc_AllocStats;
+
+// install a user allocator, pass one with a NULL funcAlloc to restore malloc/free.
+// Must be done before anything is allocated, or after everything is freed.
+void  olc_SetAllocator(olc_Allocator allocator);
+// get the live statistics of one olc_AllocCategory
+olc_AllocStats olc_GetAllocStats(uint32_t category);
+// when enabled, every allocation made inside olc_PGE_CoreUpdate is reported on
+// stderr; enable it once the application has warmed up to catch per frame churn
+void  olc_SetAllocDebug(bool bEnable);
+// number of allocations made during the last call to olc_PGE_CoreUpdate
+uint32_t olc_GetFrameAllocations();
+
+// allocate through the installed allocator, NULL on failure
+void* olc_Malloc(size_t size, uint32_t category);
+// as olc_Malloc, with the memory cleared to zero
+void* olc_Calloc(size_t count, size_t size, uint32_t category);
+// resize memory from olc_Malloc/olc_Calloc, p may be NULL, NULL on failure
+void* olc_Realloc(void* p, size_t size, uint32_t category);
+// release memory from olc_Malloc/olc_Calloc/olc_Realloc, p may be NULL
+void  olc_Free(void* p);
+// allocate size bytes starting on an alignment byte boundary (power of two)
+void* olc_AlignedAlloc(size_t size, size_t alignment, uint32_t category);
+// release memory obtained from olc_AlignedAlloc
+void  olc_AlignedFree(void* p);
+
 typedef struct vector
 {
     size_t capacity;
@@ -40,6 +95,96 @@ void vector_remove(vector* v, size_t index);
 // get number of elements currently stored in the provided vector
 size_t vector_size(vector* v);
 
+// Typed vector, generated per element type with OLC_VECTOR_DEFINE(T). Unlike
+// the vector above, elements are stored by value in one contiguous block, so
+// pushing does not allocate per element and iterating walks memory linearly.
+// T must be a single identifier, typedef pointer or struct types first.
+// Storage is accounted as olc_ALLOC_CONTAINERS unless a category is given.
+#define OLC_VECTOR_DEFINE(T) OLC_VECTOR_DEFINE_CATEGORY(T, olc_ALLOC_CONTAINERS)
+
+#define OLC_VECTOR_DEFINE_CATEGORY(T, category)                                        \
+typedef struct olc_vector_##T                                                          \
+{                                                                                      \
+    size_t capacity;                                                                   \
+    T* items;                                                                          \
+    size_t size;                                                                       \
+} olc_vector_##T;                                                                      \
+                                                                                       \
+/* init vector struct */                                                               \
+static inline void olc_vector_##T##_init(olc_vector_##T* v)                            \
+{ v->capacity = 0; v->items = NULL; v->size = 0; }                                     \
+                                                                                       \
+/* free the element storage and reset capacity and size to 0 */                        \
+static inline void olc_vector_##T##_free(olc_vector_##T* v)                            \
+{ olc_Free(v->items); olc_vector_##T##_init(v); }                                      \
+                                                                                       \
+/* drop every element, keeping the storage for reuse */                                \
+static inline void olc_vector_##T##_clear(olc_vector_##T* v)                           \
+{ v->size = 0; }                                                                       \
+                                                                                       \
+/* ensure room for at least capacity elements */                                       \
+static inline void olc_vector_##T##_reserve(olc_vector_##T* v, size_t capacity)        \
+{                                                                                      \
+    if(capacity <= v->capacity) return;                                                \
+    T* items = (T*)olc_Realloc(v->items, sizeof(T) * capacity, category);              \
+    if(items == NULL)                                                                  \
+    {                                                                                  \
+        fprintf(stderr, "Failed to grow vector of " #T ".\n");                         \
+        exit(EXIT_FAILURE);                                                            \
+    }                                                                                  \
+    v->items = items;                                                                  \
+    v->capacity = capacity;                                                            \
+}                                                                                      \
+                                                                                       \
+/* ensure room for count more elements, growing geometrically */                       \
+static inline void olc_vector_##T##_grow(olc_vector_##T* v, size_t count)              \
+{                                                                                      \
+    if(v->size + count <= v->capacity) return;                                         \
+    size_t capacity = (v->capacity == 0) ? 8 : v->capacity * 2;                        \
+    while(capacity < v->size + count) capacity *= 2;                                   \
+    olc_vector_##T##_reserve(v, capacity);                                             \
+}                                                                                      \
+                                                                                       \
+/* append an uninitialised element and return it, valid until the next growth */       \
+static inline T* olc_vector_##T##_emplace(olc_vector_##T* v)                           \
+{ olc_vector_##T##_grow(v, 1); return &v->items[v->size++]; }                          \
+                                                                                       \
+/* copy the provided item to the end of the vector, returning its index */             \
+static inline size_t olc_vector_##T##_push(olc_vector_##T* v, T item)                  \
+{ *olc_vector_##T##_emplace(v) = item; return v->size - 1; }                           \
+                                                                                       \
+/* copy count items to the end of the vector in one go */                              \
+static inline void olc_vector_##T##_append(olc_vector_##T* v, const T* items, size_t count) \
+{                                                                                      \
+    if(count == 0) return;                                                             \
+    olc_vector_##T##_grow(v, count);                                                   \
+    memcpy(&v->items[v->size], items, sizeof(T) * count);                              \
+    v->size += count;                                                                  \
+}                                                                                      \
+                                                                                       \
+/* get a pointer to the element at the provided index, NULL if out of bounds */        \
+static inline T* olc_vector_##T##_get(olc_vector_##T* v, size_t index)                 \
+{ return (index < v->size) ? &v->items[index] : NULL; }                                \
+                                                                                       \
+/* delete the element at the provided index, keeping the order of the rest */          \
+static inline void olc_vector_##T##_remove(olc_vector_##T* v, size_t index)            \
+{                                                                                      \
+    if(index >= v->size) return;                                                       \
+    memmove(&v->items[index], &v->items[index + 1], sizeof(T) * (v->size - index - 1)); \
+    v->size--;                                                                         \
+}                                                                                      \
+                                                                                       \
+/* delete the element at the provided index by moving the last one into its place */   \
+static inline void olc_vector_##T##_swap_remove(olc_vector_##T* v, size_t index)       \
+{                                                                                      \
+    if(index >= v->size) return;                                                       \
+    v->items[index] = v->items[--v->size];                                             \
+}                                                                                      \
+                                                                                       \
+/* get number of elements currently stored in the provided vector */                   \
+static inline size_t olc_vector_##T##_size(olc_vector_##T* v)                          \
+{ return v->size; }
+
 
 #define UNUSED(x) (void)(x)
 #define olc_MIN(a, b) (a < b) ? a : b
@@ -55,6 +200,14 @@ size_t vector_size(vector* v);
 
 #define olc_SOLID 0xffffffff
 
+// What FillPolygon counts as inside: an odd number of edges crossed on the way
+// out, or edges crossed that don't cancel out by direction
+enum olc_FillRule
+{
+    olc_FILLRULE_EVENODD,
+    olc_FILLRULE_NONZERO
+};
+
 enum olc_rcode
 {
     olc_RCODE_FAIL = 0,
@@ -76,7 +229,8 @@ enum olc_PixelMode
     olc_PIXELMODE_NORMAL,
     olc_PIXELMODE_MASK,
     olc_PIXELMODE_ALPHA,
-    olc_PIXELMODE_CUSTOM
+    olc_PIXELMODE_CUSTOM,
+    olc_PIXELMODE_CUSTOM_SPAN
 };
 
 olc_Pixel olc_PixelDefault();
@@ -87,6 +241,41 @@ olc_Pixel olc_PixelF(float red, float green, float blue, float alpha);
 bool      olc_PixelCompare(olc_Pixel a, olc_Pixel b);
 void olc_PixelColourInit();
 
+// O------------------------------------------------------------------------------O
+// | olc_SpanKernels - Inner loops over runs of 32-Bit pixels                     |
+// O------------------------------------------------------------------------------O
+// One table of kernels is selected at start up from what the CPU supports
+// (AVX2, SSE2 or plain C). dst and src need no particular alignment, and
+// count may be zero. Define OLC_NO_SIMD to always use the plain C kernels.
+typedef struct SpanKernels
+{
+    const char* sName;
+    // dst[i] = p
+    void (*fill)(uint32_t* dst, uint32_t p, int32_t count);
+    // dst[i] = src[i]
+    void (*copy)(uint32_t* dst, const uint32_t* src, int32_t count);
+    // dst[i] = src[i] where src[i] is fully opaque
+    void (*copyMasked)(uint32_t* dst, const uint32_t* src, int32_t count);
+    // dst[i] = src[i] over dst[i], weighted by src alpha and nBlend (8.8 fixed-point, 0 to 256)
+    void (*blend)(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend);
+    // dst[i] = p over dst[i], weighted by p's alpha and nBlend (8.8 fixed-point, 0 to 256)
+    void (*fillBlend)(uint32_t* dst, olc_Pixel p, int32_t count, uint32_t nBlend);
+    // dst[i] = src[i] modulated by tint, per channel
+    void (*copyTinted)(uint32_t* dst, const uint32_t* src, int32_t count, olc_Pixel tint);
+    // dst[i] = premultiplied src[i] over dst[i], src weighted by nBlend (8.8 fixed-point, 0 to 256)
+    void (*blendPremul)(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend);
+    // dst[i] = bilinear blend of taps[4i] to taps[4i+3] (top left, top right, bottom left,
+    // bottom right), weights[i] = wx | wy << 16 with wx, wy 0 to 255 toward the right and bottom
+    void (*bilerp)(uint32_t* dst, const uint32_t* taps, const uint32_t* weights, int32_t count);
+    // dst[i] = rounded mean of row0[2i], row0[2i+1], row1[2i] and row1[2i+1]
+    void (*downsample)(uint32_t* dst, const uint32_t* row0, const uint32_t* row1, int32_t count);
+} olc_SpanKernels;
+
+// EXTERN!!! Thanks Gusgo
+extern olc_SpanKernels olc_Span;
+// select the fastest kernels this CPU supports
+void olc_SpanKernels_Init();
+
 // O------------------------------------------------------------------------------O
 // | USEFUL CONSTANTS / AND SOME JUST STATIC ONES                                 |
 // O------------------------------------------------------------------------------O
@@ -139,6 +328,41 @@ olc_vi2d olc_VI2D(int x, int y);
 olc_vf2d olc_VF2D(float x, float y);
 olc_vd2d olc_VD2D(double x, double y);
 
+// O------------------------------------------------------------------------------O
+// | olc_Transform2D - An affine transform of the 2D plane                        |
+// O------------------------------------------------------------------------------O
+// A point (x,y) maps to (m[0][0]*x + m[0][1]*y + m[0][2], m[1][0]*x + m[1][1]*y + m[1][2]).
+// Translate, Rotate, Scale and Shear return t followed by that operation, so a
+// chain of calls reads in the order the operations are applied
+typedef struct Transform2D
+{
+    float m[2][3];
+} olc_Transform2D;
+
+olc_Transform2D olc_Transform2D_Identity();
+olc_Transform2D olc_Transform2D_Translate(olc_Transform2D t, float ox, float oy);
+olc_Transform2D olc_Transform2D_Rotate(olc_Transform2D t, float fTheta);
+olc_Transform2D olc_Transform2D_Scale(olc_Transform2D t, float sx, float sy);
+olc_Transform2D olc_Transform2D_Shear(olc_Transform2D t, float sx, float sy);
+// the transform that undoes t, false if t collapses the plane and has none
+bool            olc_Transform2D_Invert(olc_Transform2D t, olc_Transform2D* inverse);
+olc_vf2d        olc_Transform2D_Forward(olc_Transform2D t, olc_vf2d p);
+
+// O------------------------------------------------------------------------------O
+// | olc_Vertex - A corner of a triangle drawn by DrawTriangles                   |
+// O------------------------------------------------------------------------------O
+
+// pos is in draw target pixels, w is the depth that divides it for perspective
+// (1 for flat 2D work) and must be above 0, uv runs from 0 to 1 across the
+// sprite and col shades it
+typedef struct Vertex
+{
+    olc_vf2d  pos;
+    float     w;
+    olc_vf2d  uv;
+    olc_Pixel col;
+} olc_Vertex;
+
 // O------------------------------------------------------------------------------O
 // | olc_HWButton - Represents the state of a hardware button (mouse/key/joy)     |
 // O------------------------------------------------------------------------------O
@@ -168,15 +392,65 @@ enum olc_SpriteFlip
     olc_SPRITEFLIP_VERT = 2
 };
 
+enum olc_SpriteFilter
+{
+    olc_SPRITEFILTER_NEAREST  = 0,
+    olc_SPRITEFILTER_BILINEAR = 1,
+    // or'd with either of the above, shrunk sprites are read from the mip level
+    // that best matches how far they are shrunk
+    olc_SPRITEFILTER_MIPMAP   = 2
+};
+
+// Pixel rows start on olc_nSpriteAlignment byte boundaries and are padded to
+// a whole number of alignment blocks, pixel (x,y) lives at pixels[y * stride + x].
+// A view (parent != NULL) borrows a sub-rectangle of its parent's pixels and
+// stride instead, so its rows carry no alignment guarantee.
+#define olc_nSpriteAlignment 64
+#define olc_nSpriteRowAlign  (olc_nSpriteAlignment / (int32_t)sizeof(uint32_t))
+
+// The fully opaque runs of a sprite's rows, used to draw it in MASK mode
+// without visiting its transparent pixels. Row y's runs are runs[rows[y]] up
+// to runs[rows[y + 1]], from left to right
+typedef struct SpriteRun
+{
+    int32_t start;
+    int32_t length;
+} olc_SpriteRun;
+
+typedef struct SpriteSpans
+{
+    int32_t* rows;
+    olc_SpriteRun* runs;
+} olc_SpriteSpans;
+
 typedef struct Sprite
 {
     int32_t width;
     int32_t height;
+    int32_t stride;
     uint32_t* pixels;
     uint32_t modeSample;
+    struct Sprite* parent;
+    // colour channels are already scaled by alpha
+    bool bPremultiplied;
+    // built on demand, NULL until then and whenever the pixels change
+    olc_SpriteSpans* spans;
+    // next mip level, see olc_Sprite_GetMip
+    struct Sprite* mip;
+    // 16 or 32-bit depth of each pixel, laid out like the pixels, NULL for
+    // none. Views use their root's
+    void* depth;
+    uint32_t nDepthBits;
 } olc_Sprite;
 
 olc_Sprite* olc_Sprite_Create(int32_t w, int32_t h);
+// as olc_Sprite_Create, but pixel contents are left undefined, for callers
+// that are about to overwrite every pixel anyway
+olc_Sprite* olc_Sprite_CreateUninitialised(int32_t w, int32_t h);
+// create a view of the region (x,y) to (x+w,y+h) of parent, clipped to it. The
+// view shares the parent's pixels, so it can be drawn from, drawn into and
+// turned into a decal without copying; it must not outlive its parent
+olc_Sprite* olc_Sprite_CreateView(olc_Sprite* parent, int32_t x, int32_t y, int32_t w, int32_t h);
 olc_Sprite* olc_Sprite_Load(const char *sImageFile);
 void        olc_Sprite_Destroy(olc_Sprite* sprite);
 
@@ -190,6 +464,51 @@ bool      olc_Sprite_SetPixel(olc_Sprite* sprite, int32_t x, int32_t y, olc_Pixe
 olc_Pixel olc_Sprite_Sample(olc_Sprite* sprite, float x, float y);
 olc_Pixel olc_Sprite_SampleBL(olc_Sprite* sprite, float u, float v);
 uint32_t* olc_Sprite_GetData(olc_Sprite* sprite);
+// distance in pixels between the starts of two consecutive rows of GetData
+int32_t   olc_Sprite_GetStride(olc_Sprite* sprite);
+// convert a straight alpha sprite to premultiplied alpha, in place
+void      olc_Sprite_Premultiply(olc_Sprite* sprite);
+// and back from premultiplied alpha to straight alpha, in place
+void      olc_Sprite_Unpremultiply(olc_Sprite* sprite);
+// the sprite that owns the pixels, following views back to their parent
+olc_Sprite* olc_Sprite_GetRoot(olc_Sprite* sprite);
+// the opaque runs of the sprite, built on first use. Views have none
+olc_SpriteSpans* olc_Sprite_GetSpans(olc_Sprite* sprite);
+// mip level of the sprite, 0 being the sprite itself and each level after half
+// the size of the one before, built on first use. Views, and the draw target
+// and its views, have no levels past 0
+olc_Sprite* olc_Sprite_GetMip(olc_Sprite* sprite, uint32_t level);
+// drop the opaque runs and mip levels after changing pixels other than through
+// SetPixel or drawing into the sprite, e.g. by writing through GetData
+void      olc_Sprite_Invalidate(olc_Sprite* sprite);
+// give the sprite a depth plane of 16 or 32 bits per pixel, all as far away as
+// can be, for SetDepthTest and SetDepthWrite to use. 0 bits takes it away
+void      olc_Sprite_SetDepth(olc_Sprite* sprite, uint32_t bits);
+
+// O------------------------------------------------------------------------------O
+// | olc_Sampler - Reads runs of filtered texels out of a sprite                  |
+// O------------------------------------------------------------------------------O
+// UVs are normalised, (0,0) is the top left corner of the sprite and (1,1) the
+// bottom right. Texel centres sit half a texel in, and UVs outside the sprite
+// are brought back onto it as the wrap mode says
+enum olc_SpriteWrap
+{
+    olc_SPRITEWRAP_CLAMP,
+    olc_SPRITEWRAP_REPEAT,
+    olc_SPRITEWRAP_MIRROR
+};
+
+typedef struct Sampler
+{
+    olc_Sprite* sprite;
+    uint32_t wrap;
+    uint32_t filter;
+} olc_Sampler;
+
+olc_Sampler olc_Sampler_Create(olc_Sprite* sprite, uint32_t wrap, uint32_t filter);
+olc_Pixel   olc_Sampler_Sample(const olc_Sampler* sampler, olc_vf2d uv);
+// fill out[0] to out[count - 1] with the samples at uv, uv + duv, uv + 2 * duv, ...
+void        olc_Sampler_SampleSpan(const olc_Sampler* sampler, olc_vf2d uv, olc_vf2d duv, olc_Pixel* out, int32_t count);
 
 // O------------------------------------------------------------------------------O
 // | olc_Decal - A GPU resident storage of an olc_Sprite                          |
@@ -233,7 +552,30 @@ typedef struct DecalInstance
     olc_Pixel tint[4];
 } olc_DecalInstance;
 
+// allocate a standalone decal instance, release it with olc_Free
 olc_DecalInstance* olc_DecalInstance_Create();
+// reset the provided decal instance to a full, untinted quad with no decal
+void olc_DecalInstance_Init(olc_DecalInstance* di);
+
+OLC_VECTOR_DEFINE_CATEGORY(olc_DecalInstance, olc_ALLOC_DECAL_INSTANCES)
+
+// Per-layer frame arena of decal instances. Records are stored contiguously
+// and by value, the arena is reset at the end of every frame without freeing
+// its memory, so once it has grown to the peak load no further allocations occur.
+typedef struct DecalInstanceArena
+{
+    olc_vector_olc_DecalInstance instances;
+    size_t peak;
+} olc_DecalInstanceArena;
+
+// init arena struct
+void olc_DecalInstanceArena_Init(olc_DecalInstanceArena* arena);
+// free the memory used by the arena and reset capacity, size and peak to 0
+void olc_DecalInstanceArena_Free(olc_DecalInstanceArena* arena);
+// forget every instance in the arena, keeping its memory for the next frame
+void olc_DecalInstanceArena_Reset(olc_DecalInstanceArena* arena);
+// append a default initialised instance, pointer is valid until the next push
+olc_DecalInstance* olc_DecalInstanceArena_Push(olc_DecalInstanceArena* arena);
 
 // NOT IMPLEMENTED - Here for Reasons
 typedef struct DecalTriangleInstance
@@ -252,11 +594,51 @@ typedef struct LayerDesc
     bool bUpdate;
     olc_Sprite* pDrawTarget;
     uint32_t nResID;
-    vector vecDecalInstance;
+    olc_DecalInstanceArena vecDecalInstance;
     olc_Pixel tint;
     void (*funcHook)();
 } olc_LayerDesc;
 
+// Layers are held by pointer, so a layer's address survives the vector growing
+typedef olc_LayerDesc* olc_LayerDescPtr;
+OLC_VECTOR_DEFINE(olc_LayerDescPtr)
+
+// Half widths of the rows of a filled rx by ry ellipse, row t above or below
+// the centre spanning centre - halfWidths[t] to centre + halfWidths[t]
+typedef struct EllipseSpans
+{
+    int32_t rx, ry;
+    int32_t* halfWidths;
+    uint32_t nLastUsed;
+} olc_EllipseSpans;
+
+// A vertex as DrawTriangles sets it up: 24.8 fixed-point position, then 1/w
+// and u, v, r, g, b, a each divided by w. 1/w is 0 for a vertex at w <= 0
+typedef struct MeshVertex
+{
+    int64_t X, Y;
+    float f[7];
+} olc_MeshVertex;
+
+// An edge as FillPolygon steps it down the rows [yStart, yEnd): q is the first
+// pixel at or right of it, floor of a fraction kept as q + r / d
+typedef struct PolygonEdge
+{
+    int64_t q, r, d, dq, dr;
+    int32_t yStart, yEnd;
+    int32_t winding;
+} olc_PolygonEdge;
+
+// A run of row y from xl to xr that FloodFill has yet to look along
+typedef struct FloodSpan
+{
+    int32_t xl, xr, y;
+} olc_FloodSpan;
+
+// Ellipses taller than this are worked out a row at a time as they are drawn
+#define olc_nEllipseCacheSize 16
+#define olc_nEllipseCacheMaxRadius 1024
+
 // State Machine!
 typedef struct
 {
@@ -273,6 +655,11 @@ typedef struct
     olc_Sprite* pDrawTarget;
     int32_t     nPixelMode;
     float		fBlendFactor;
+    uint32_t    nBlendFactor;
+    bool        bPremultipliedAlpha;
+    bool        bDepthTest;
+    bool        bDepthWrite;
+    uint32_t    nDrawDepth;
     olc_vi2d    vScreenSize;
     olc_vf2d    vInvScreenSize;
     olc_vi2d    vPixelSize;
@@ -295,12 +682,34 @@ typedef struct
     olc_Sprite* fontSprite;
     olc_Decal*  fontDecal;
     olc_Sprite* pDefaultDrawTarget;
-    vector      vLayers;
+    olc_vector_olc_LayerDescPtr vLayers;
     uint8_t		nTargetLayer;
     uint32_t	nLastFPS;
     olc_Pixel (*funcPixelMode)(int x, int y, olc_Pixel p1, olc_Pixel p2);
+    void (*funcSpanMode)(int x, int y, const olc_Pixel* src, olc_Pixel* dst, int count);
     uint64_t tp1, tp2;
 
+    // Span tables of recently drawn circles and ellipses
+    olc_EllipseSpans vEllipseCache[olc_nEllipseCacheSize];
+    uint32_t         nEllipseClock;
+
+    // DrawTriangles' vertex set up, kept for the next mesh
+    olc_MeshVertex* pMeshScratch;
+    uint32_t        nMeshScratch;
+
+    // FillPolygon's edges and active edge list, likewise
+    olc_PolygonEdge* pPolygonEdges;
+    uint32_t*        pPolygonActive;
+    uint32_t         nPolygonScratch;
+
+    // FloodFill's span stack, and the stamps marking the pixels it has filled
+    olc_FloodSpan* pFloodSpans;
+    uint32_t       nFloodSpans;
+    uint32_t       nFloodSpanCapacity;
+    uint8_t*       pFloodStamps;
+    size_t         nFloodStampSize;
+    uint8_t        nFloodStamp;
+
     // State of keyboard		
     bool         pKeyNewState[256];
     bool         pKeyOldState[256];
@@ -391,6 +800,10 @@ void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, olc_Pixel p, uint3
 void DrawCircle(int32_t x, int32_t y, int32_t radius, olc_Pixel p, uint8_t mask);
 // Fills a circle located at (x,y) with radius
 void FillCircle(int32_t x, int32_t y, int32_t radius, olc_Pixel p);
+// Draws an ellipse located at (x,y) with radii rx and ry
+void DrawEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry, olc_Pixel p);
+// Fills an ellipse located at (x,y) with radii rx and ry
+void FillEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry, olc_Pixel p);
 // Draws a rectangle at (x,y) to (x+w,y+h)
 void DrawRect(int32_t x, int32_t y, int32_t w, int32_t h, olc_Pixel p);
 // Fills a rectangle at (x,y) to (x+w,y+h)
@@ -399,11 +812,26 @@ void FillRect(int32_t x, int32_t y, int32_t w, int32_t h, olc_Pixel p);
 void DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc_Pixel p);
 // Flat fills a triangle between points (x1,y1), (x2,y2) and (x3,y3)
 void FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, olc_Pixel p);
+// Fills the polygon through count points, concave or crossing itself, inside
+// being decided by olc_FILLRULE_EVENODD or olc_FILLRULE_NONZERO
+void FillPolygon(const olc_vi2d* points, uint32_t count, olc_Pixel p, uint32_t rule);
+// Fills the region joined to (x,y) whose colours are within tolerance, on
+// every channel, of the colour at (x,y), in the current pixel mode
+void FloodFill(int32_t x, int32_t y, olc_Pixel p, uint32_t tolerance);
+// Draws the triangles of an indexed mesh, count being the number of indices,
+// textured from sprite when it isn't NULL and shaded by the vertex colours.
+// Triangles with an index of nVertices or more are skipped, and so are those
+// with a vertex at w <= 0, as there is no clipping against the near plane
+void DrawTriangles(const olc_Vertex* vertices, uint32_t nVertices, const uint32_t* indices, uint32_t count, olc_Sprite* sprite);
 // Draws an entire sprite at well in my defencelocation (x,y)
 void DrawSprite(int32_t x, int32_t y, olc_Sprite *sprite, uint32_t scale, uint8_t flip);
 // Draws an area of a sprite at location (x,y), where the
 // selected area is (ox,oy) to (ox+w,oy+h)
 void DrawPartialSprite(int32_t x, int32_t y, olc_Sprite *sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale, uint8_t flip);
+// Draws a sprite placed by an affine transform from sprite pixel space to draw
+// target space, sampled with olc_SPRITEFILTER_NEAREST or olc_SPRITEFILTER_BILINEAR,
+// optionally or'd with olc_SPRITEFILTER_MIPMAP
+void DrawTransformedSprite(olc_Sprite* sprite, olc_Transform2D transform, uint32_t filter);
 
 
 // Decal Quad functions
@@ -448,8 +876,10 @@ void SetLayerOffset(uint8_t layer, float x, float y);
 void SetLayerScale(uint8_t layer, float x, float y);
 void SetLayerTint(uint8_t layer, const olc_Pixel tint);
 void SetLayerCustomRenderFunction(uint8_t layer, void (*f)());
+// Returns the highest number of decal instances submitted to a layer in one frame
+size_t GetLayerDecalInstancePeak(uint8_t layer);
 
-vector GetLayers();
+olc_vector_olc_LayerDescPtr GetLayers();
 uint32_t CreateLayer();
 
 // Change the pixel mode for different optimisations
@@ -460,8 +890,27 @@ void SetPixelMode(int32_t m);
 int32_t GetPixelMode();
 // Use a custom blend function
 void SetCustomPixelMode(olc_Pixel (*f)(int x, int y, olc_Pixel p1, olc_Pixel p2));
+// Use a custom blend function called once per run of pixels rather than once per
+// pixel: it must combine src[i] into dst[i] for the count pixels that start at
+// (x,y) and run to the right. Row fills and sprite blits pass whole runs, Draw
+// and lines pass one pixel at a time (count 1), and text is unaffected as
+// DrawString switches to MASK or ALPHA mode while it draws
+void SetCustomSpanPixelMode(void (*f)(int x, int y, const olc_Pixel* src, olc_Pixel* dst, int count));
 // Change the blend factor form between 0.0f to 1.0f;
 void SetPixelBlend(float fBlend);
+// Store sprites loaded from now on, and every layer, with premultiplied alpha.
+// Premultiplied sprites blend with one multiply per channel fewer, and are
+// filtered without dark fringes when scaled as decals
+void SetPremultipliedAlpha(bool bPremultiplied);
+bool IsPremultipliedAlpha();
+// Draw only pixels no further away than the draw target's depth plane holds,
+// see olc_Sprite_SetDepth. Clear resets the plane along with the pixels
+void SetDepthTest(bool bTest);
+// Record the depth of each pixel drawn in the draw target's depth plane
+void SetDepthWrite(bool bWrite);
+// Depth of everything drawn from now on, 0 nearest to 1 furthest, so drawing
+// order no longer decides what ends up in front
+void SetDrawDepth(float fDepth);
 // Offset texels by sub-pixel amount (advanced, do not use)
 void SetSubPixelOffset(float ox, float oy);
 
@@ -491,21 +940,39 @@ void olc_PGE_Terminate();
 static SDL_Window*   olc_Window;
 static SDL_Renderer* olc_Renderer;
 static SDL_Rect rViewport;
+static SDL_BlendMode modePremultiplied;
+// Texture ids handed out by the renderer are slot map handles: the low bits
+// index a slot and the high bits hold the generation of that slot, which is
+// bumped whenever the texture in it is deleted. Slots are reused, and a stale
+// id no longer matches its slot's generation, so lookups on it fail safely.
+#define olc_TEXTURE_INDEX_BITS      20
+#define olc_TEXTURE_INDEX_MASK      ((1u << olc_TEXTURE_INDEX_BITS) - 1)
+#define olc_TEXTURE_GENERATION_MASK 0x7FFu
+#define olc_TEXTURE_NO_SLOT         0xFFFFFFFFu
+
 typedef struct
 {
-    int id;
+    uint32_t generation;
+    uint32_t nextFree;
     SDL_Texture* t;
 } texturedata;
 
-static vector mapTextures;
-static int nActiveTexture = -1;
-static int nTextureID = 0;
+OLC_VECTOR_DEFINE_CATEGORY(texturedata, olc_ALLOC_TEXTURES)
+
+typedef struct
+{
+    olc_vector_texturedata slots;
+    uint32_t freeHead;
+} texturemap;
+
+static texturemap mapTextures;
+static uint32_t nActiveTexture = olc_TEXTURE_NO_SLOT;
 
-void texturemap_init(vector *v);
-void texturemap_destroy(vector* v);
-void texturemap_delete(vector* v, int id);
-SDL_Texture* texturemap_get(vector* v, int id);
-void texturemap_set(vector* v, int id, SDL_Texture* texture);
+void         texturemap_init(texturemap* m);
+void         texturemap_destroy(texturemap* m);
+void         texturemap_delete(texturemap* m, uint32_t id);
+SDL_Texture* texturemap_get(texturemap* m, uint32_t id);
+uint32_t     texturemap_insert(texturemap* m, SDL_Texture* texture);
 
 void       olc_Renderer_PrepareDevice();
 int32_t    olc_Renderer_CreateDevice(bool bFullScreen, bool bVSYNC);
@@ -516,25 +983,20 @@ void       olc_Renderer_DrawLayerQuad(olc_vf2d offset, olc_vf2d scale, const olc
 void       olc_Renderer_DrawDecalQuad(olc_DecalInstance* decal);
 uint32_t   olc_Renderer_CreateTexture(const uint32_t width, const uint32_t height);
 void       olc_Renderer_UpdateTexture(uint32_t id, olc_Sprite* spr);
+void       olc_Renderer_SetTexturePremultiplied(uint32_t id, bool bPremultiplied);
 uint32_t   olc_Renderer_DeleteTexture(const uint32_t id);
 void       olc_Renderer_ApplyTexture(uint32_t id);
 void       olc_Renderer_UpdateViewport(const olc_vi2d pos, const olc_vi2d size);
 void       olc_Renderer_ClearBuffer(olc_Pixel p, bool bDepth);
 
 
-typedef struct 
-{
-    size_t key;
-    uint8_t val;
-} inputdata;
-
-static vector mapKeys;
+// SDL keycodes are either plain characters (below 128) or scancodes tagged
+// with SDLK_SCANCODE_MASK, so both fold into one flat, constant table
+#define olc_nKeyMapChars 128
+#define olc_nKeyMapSize  (olc_nKeyMapChars + SDL_NUM_SCANCODES)
 
-void    inputmap_init(vector *v);
-void    inputmap_destroy(vector* v);
-void    inputmap_delete(vector* v, size_t key);
-uint8_t inputmap_get(vector* v, size_t key);
-void    inputmap_set(vector* v, size_t key, uint8_t val);
+// translate an SDL keycode to an olc_Key, olc_NONE if it is not mapped
+uint8_t inputmap_get(SDL_Keycode key);
 
 int32_t olc_Platform_ApplicationStartUp();
 int32_t olc_Platform_ApplicationCleanUp();
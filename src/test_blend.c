@@ -0,0 +1,194 @@
+// ALPHA mode blend test
+//
+// Checks the 8.8 fixed-point blend of every kernel set this CPU can run
+// (plain C, SSE2, AVX2), and Draw, bit for bit against a double precision
+// reference, over every source alpha, source channel and destination channel
+// at several blend factors, and over short and misaligned runs so the vector
+// kernels' tails are covered. Build it like test.c, against engine.c and SDL2.
+// Exits with 0 if nothing mismatched.
+#include "engine.h"
+
+// The kernels themselves are internal to engine.c, so they are declared here
+void span_blend_c(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend);
+void span_fill_blend_c(uint32_t* dst, olc_Pixel p, int32_t count, uint32_t nBlend);
+
+#if !defined(OLC_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+    #define OLC_SIMD_X86
+    void span_blend_sse2(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend);
+    void span_fill_blend_sse2(uint32_t* dst, olc_Pixel p, int32_t count, uint32_t nBlend);
+    void span_blend_avx2(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend);
+    void span_fill_blend_avx2(uint32_t* dst, olc_Pixel p, int32_t count, uint32_t nBlend);
+#endif
+
+typedef struct
+{
+    const char* sName;
+    void (*blend)(uint32_t* dst, const uint32_t* src, int32_t count, uint32_t nBlend);
+    void (*fillBlend)(uint32_t* dst, olc_Pixel p, int32_t count, uint32_t nBlend);
+} BlendKernels;
+
+// one channel of the blend in double precision, s lerped toward d by a / 255
+// and rounded to nearest. Tabulated once, for every weight and pair of values
+uint8_t* pLerp;
+
+void reference_init()
+{
+    pLerp = (uint8_t*)malloc(256 * 256 * 256);
+
+    for(uint32_t a = 0; a < 256; a++)
+        for(uint32_t s = 0; s < 256; s++)
+            for(uint32_t d = 0; d < 256; d++)
+                pLerp[(a << 16) | (s << 8) | d] = (uint8_t)floor(((double)s * a + (double)d * (255.0 - a)) / 255.0 + 0.5);
+}
+
+// s over d: the weight is s's alpha scaled by the blend factor and rounded to
+// 8 bits, channels are lerped, and alpha is the "over" coverage a + d.a * (1 - a)
+uint32_t reference(uint32_t s, uint32_t d, uint32_t nBlend)
+{
+    uint32_t a = (uint32_t)floor((double)(s >> 24) * (double)nBlend / 256.0 + 0.5);
+    uint32_t r = 0;
+
+    s |= 0xFF000000;
+    for(int32_t sh = 0; sh < 32; sh += 8)
+        r |= (uint32_t)pLerp[(a << 16) | (((s >> sh) & 0xFF) << 8) | ((d >> sh) & 0xFF)] << sh;
+
+    return r;
+}
+
+uint32_t nErrors = 0;
+
+void expect(const char* sWhat, uint32_t got, uint32_t s, uint32_t d, uint32_t nBlend)
+{
+    uint32_t want = reference(s, d, nBlend);
+    if(got == want) return;
+
+    if(nErrors++ < 10)
+        printf("  %s: src %08X dst %08X blend %u gave %08X, expected %08X\n", sWhat, s, d, nBlend, got, want);
+}
+
+// every source alpha, source channel and destination channel, with the
+// channels of each pixel spread out so that no two lanes see the same values
+void test_exhaustive(const BlendKernels* k, uint32_t nBlend)
+{
+    uint32_t src[256], dst[256], out[256];
+
+    for(uint32_t d = 0; d < 256; d++)
+        dst[d] = (d << 24) | (((d * 97) & 0xFF) << 16) | (((d * 31) & 0xFF) << 8) | d;
+
+    for(uint32_t sa = 0; sa < 256; sa++)
+    {
+        for(uint32_t sc = 0; sc < 256; sc++)
+        {
+            for(uint32_t i = 0; i < 256; i++)
+                src[i] = (sa << 24) | (((sc + i) & 0xFF) << 16) | (((sc * 3 + i) & 0xFF) << 8) | sc;
+
+            memcpy(out, dst, sizeof(out));
+            k->blend(out, src, 256, nBlend);
+            for(uint32_t i = 0; i < 256; i++)
+                expect(k->sName, out[i], src[i], dst[i], nBlend);
+
+            memcpy(out, dst, sizeof(out));
+            k->fillBlend(out, olc_PixelRAW(src[0]), 256, nBlend);
+            for(uint32_t i = 0; i < 256; i++)
+                expect(k->sName, out[i], src[0], dst[i], nBlend);
+        }
+    }
+}
+
+// every run length up to a few vector widths, at every alignment, with guard
+// pixels either side that must be left alone
+void test_tails(const BlendKernels* k)
+{
+    uint32_t src[64], dst[64], out[64];
+    uint32_t seed = 99;
+
+    for(int32_t i = 0; i < 64; i++)
+    {
+        seed = seed * 1664525u + 1013904223u; src[i] = seed;
+        seed = seed * 1664525u + 1013904223u; dst[i] = seed;
+    }
+
+    for(int32_t offset = 0; offset < 8; offset++)
+    {
+        for(int32_t count = 0; count <= 40; count++)
+        {
+            for(int32_t f = 0; f < 2; f++)
+            {
+                memcpy(out, dst, sizeof(out));
+                if(f == 0) k->blend(out + 8 + offset, src + 8 + offset, count, 200);
+                else k->fillBlend(out + 8 + offset, olc_PixelRAW(src[0]), count, 200);
+
+                for(int32_t i = 0; i < 64; i++)
+                {
+                    bool bInside = i >= 8 + offset && i < 8 + offset + count;
+                    if(!bInside && out[i] != dst[i] && nErrors++ < 10)
+                        printf("  %s: run of %d at %d wrote outside it, at %d\n", k->sName, count, 8 + offset, i);
+                    if(bInside) expect(k->sName, out[i], (f == 0) ? src[i] : src[0], dst[i], 200);
+                }
+            }
+        }
+    }
+}
+
+// Draw in ALPHA mode, which blends single pixels
+void test_draw()
+{
+    olc_Sprite* target = olc_Sprite_Create(256, 1);
+    SetDrawTarget(target);
+    SetPixelMode(olc_PIXELMODE_ALPHA);
+
+    uint32_t nBlends[] = { 256, 179, 64 };
+    for(uint32_t b = 0; b < 3; b++)
+    {
+        SetPixelBlend((float)nBlends[b] / 256.0f);
+
+        for(uint32_t sa = 0; sa < 256; sa += 3)
+        {
+            for(uint32_t x = 0; x < 256; x++)
+            {
+                uint32_t s = (sa << 24) | (x << 16) | ((255 - x) << 8) | (sa ^ x);
+                uint32_t d = ((x * 13) & 0xFF) << 24 | ((x * 7) & 0xFF) << 16 | x << 8 | (255 - x);
+                target->pixels[x] = d;
+                Draw(x, 0, olc_PixelRAW(s));
+                expect("Draw", target->pixels[x], s, d, nBlends[b]);
+            }
+        }
+    }
+
+    SetPixelMode(olc_PIXELMODE_NORMAL);
+    SetPixelBlend(1.0f);
+    olc_Sprite_Destroy(target);
+}
+
+int main(int argc, char* argv[])
+{
+    UNUSED(argc); UNUSED(argv);
+
+    if(Construct(256, 1, 1, 1, false, false) != olc_RCODE_OK) return 1;
+    reference_init();
+
+    BlendKernels kernels[3];
+    uint32_t nKernels = 0;
+    kernels[nKernels++] = (BlendKernels){ "C", &span_blend_c, &span_fill_blend_c };
+#ifdef OLC_SIMD_X86
+    if(SDL_HasSSE2()) kernels[nKernels++] = (BlendKernels){ "SSE2", &span_blend_sse2, &span_fill_blend_sse2 };
+    if(SDL_HasAVX2()) kernels[nKernels++] = (BlendKernels){ "AVX2", &span_blend_avx2, &span_fill_blend_avx2 };
+#endif
+
+    uint32_t nBlends[] = { 0, 1, 128, 255, 256, 203 };
+    for(uint32_t k = 0; k < nKernels; k++)
+    {
+        uint32_t nBefore = nErrors;
+        for(uint32_t b = 0; b < sizeof(nBlends) / sizeof(nBlends[0]); b++)
+            test_exhaustive(&kernels[k], nBlends[b]);
+        test_tails(&kernels[k]);
+        printf("%-5s %u mismatches\n", kernels[k].sName, nErrors - nBefore);
+    }
+
+    uint32_t nBefore = nErrors;
+    test_draw();
+    printf("%-5s %u mismatches\n", "Draw", nErrors - nBefore);
+
+    free(pLerp);
+    return (nErrors == 0) ? 0 : 1;
+}